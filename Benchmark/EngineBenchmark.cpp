@@ -0,0 +1,454 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.cpp
+    Created: 18 Oct 2026 1:12:30pm
+    Author:  Chandrasekaran Akhshayaa
+
+    Headless benchmark for the deck/mixer engine. Builds a DJMixer without
+    any GUI, feeds it synthetic or user-supplied tracks and pulls blocks
+    from it with a fake audio device, sweeping deck count, block size,
+    sample rate, speed and EQ.
+
+    Usage:
+        OtoDecksBenchmark [--quick] [--seconds N] [--csv results.csv] [--spectrum]
+                          [--decks 1,2,4] [--blocks 32,64,...] [--rates 44100,...]
+                          [file1.wav file2.mp3 ...]
+        OtoDecksBenchmark --determinism mixlog.json [--blocks 512]
+
+    The second form renders a recorded mix offline twice and fails unless
+    both renders are identical to the last bit.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/DJMixer.h"
+#include "../Source/OfflineMixRenderer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <vector>
+
+//==============================================================================
+// Allocation counting. Only allocations made on the thread that is inside a
+// fake-device callback are counted.
+//==============================================================================
+
+namespace
+{
+    std::atomic<int64> allocationCount { 0 };
+    thread_local bool countAllocations = false;
+
+    inline void noteAllocation()
+    {
+        if (countAllocations)
+            allocationCount.fetch_add (1, std::memory_order_relaxed);
+    }
+}
+
+#if defined (__GLIBC__)
+// Wrap the C allocator so HeapBlock/AudioBuffer allocations (which use
+// std::malloc directly) are counted too. operator new goes through malloc.
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+
+    void* malloc (size_t size)               { noteAllocation(); return __libc_malloc (size); }
+    void* calloc (size_t n, size_t size)     { noteAllocation(); return __libc_calloc (n, size); }
+    void* realloc (void* p, size_t size)     { noteAllocation(); return __libc_realloc (p, size); }
+}
+#else
+void* operator new (std::size_t size)
+{
+    noteAllocation();
+
+    if (auto* p = std::malloc (size == 0 ? 1 : size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)                   { return operator new (size); }
+void operator delete (void* p) noexcept                   { std::free (p); }
+void operator delete[] (void* p) noexcept                 { std::free (p); }
+void operator delete (void* p, std::size_t) noexcept      { std::free (p); }
+void operator delete[] (void* p, std::size_t) noexcept    { std::free (p); }
+#endif
+
+//==============================================================================
+namespace
+{
+    struct BenchConfig
+    {
+        int numDecks = 2;
+        int blockSize = 512;
+        double sampleRate = 44100.0;
+        double speed = 1.0;
+        bool eqBoost = false;
+        bool spectrum = false;     // feed every analyser, as if all were shown
+    };
+
+    struct BenchResult
+    {
+        double nsPerSample = 0.0;
+        double meanCallbackUs = 0.0;
+        double p99CallbackUs = 0.0;
+        double maxCallbackUs = 0.0;
+        double allocationsPerCallback = 0.0;
+        double realtimeFactor = 0.0;
+        int underruns = 0;          // blocks whose read-ahead wasn't ready in time
+    };
+
+    /** Stands in for an audio device: owns the output buffer and calls the
+        mixer back-to-back, timing every callback. Before each one it waits,
+        untimed, for the decks' read-ahead, so the run measures decoded audio
+        rather than the silence a starved BufferingAudioSource plays. */
+    class FakeAudioDevice
+    {
+    public:
+        FakeAudioDevice (int blockSizeToUse, double sampleRateToUse)
+            : blockSize (blockSizeToUse), sampleRate (sampleRateToUse), buffer (2, blockSizeToUse)
+        {
+        }
+
+        BenchResult run (DJMixer& source, double secondsToRender)
+        {
+            source.prepareToPlay (blockSize, sampleRate);
+
+            // Let the decks settle (first reads, filter state) before measuring
+            for (int i = 0; i < 16; ++i)
+            {
+                source.waitForReadAhead (blockSize, readAheadTimeoutMs);
+                callback (source);
+            }
+
+            const int numCallbacks = jmax (64, (int) std::ceil (secondsToRender * sampleRate / blockSize));
+            std::vector<double> callbackNs;
+            callbackNs.reserve ((size_t) numCallbacks);
+
+            allocationCount = 0;
+            int underruns = 0;
+            const double ticksToNs = 1.0e9 / (double) Time::getHighResolutionTicksPerSecond();
+
+            for (int i = 0; i < numCallbacks; ++i)
+            {
+                if (! source.waitForReadAhead (blockSize, readAheadTimeoutMs))
+                    ++underruns;
+
+                const auto start = Time::getHighResolutionTicks();
+                countAllocations = true;
+                callback (source);
+                countAllocations = false;
+                const auto end = Time::getHighResolutionTicks();
+
+                callbackNs.push_back ((double) (end - start) * ticksToNs);
+            }
+
+            source.releaseResources();
+
+            BenchResult r;
+            double total = 0.0;
+            for (auto ns : callbackNs) total += ns;
+
+            std::sort (callbackNs.begin(), callbackNs.end());
+            const auto p99Index = jmin (callbackNs.size() - 1, (size_t) std::ceil (0.99 * (double) callbackNs.size()) - 1);
+
+            r.nsPerSample = total / ((double) numCallbacks * blockSize);
+            r.meanCallbackUs = total / numCallbacks / 1000.0;
+            r.p99CallbackUs = callbackNs[p99Index] / 1000.0;
+            r.maxCallbackUs = callbackNs.back() / 1000.0;
+            r.allocationsPerCallback = (double) allocationCount.load() / numCallbacks;
+            r.realtimeFactor = (1.0e9 / sampleRate) / jmax (1.0e-9, r.nsPerSample);
+            r.underruns = underruns;
+            return r;
+        }
+
+    private:
+        static constexpr int readAheadTimeoutMs = 2000;
+
+        void callback (AudioSource& source)
+        {
+            buffer.clear();
+            AudioSourceChannelInfo info (&buffer, 0, blockSize);
+            source.getNextAudioBlock (info);
+        }
+
+        int blockSize;
+        double sampleRate;
+        AudioBuffer<float> buffer;
+    };
+
+    /** Write a short synthetic dance loop (kick, bass, hats) to use when no
+        corpus files are given. */
+    File createSyntheticTrack (double sampleRate, double seconds)
+    {
+        auto file = File::getSpecialLocation (File::tempDirectory)
+                        .getChildFile ("otodecks_bench_" + String ((int) sampleRate) + ".wav");
+
+        if (file.existsAsFile())
+            return file;
+
+        const int numSamples = (int) (sampleRate * seconds);
+        AudioBuffer<float> audio (2, numSamples);
+
+        const double bpm = 124.0;
+        const double beatSamples = sampleRate * 60.0 / bpm;
+        Random random (1234);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double beatPos = std::fmod ((double) i, beatSamples);
+            const double t = beatPos / sampleRate;
+
+            const double kick = std::sin (MathConstants<double>::twoPi * (50.0 + 120.0 * std::exp (-t * 30.0)) * t)
+                              * std::exp (-t * 8.0);
+            const double bass = 0.3 * (2.0 * std::fmod ((double) i * 55.0 / sampleRate, 1.0) - 1.0);
+            const double hatEnv = std::exp (-std::fmod (beatPos + beatSamples * 0.5, beatSamples) / sampleRate * 60.0);
+            const double hat = 0.2 * hatEnv * (random.nextDouble() * 2.0 - 1.0);
+
+            const float s = (float) (0.5 * (kick + bass + hat));
+            audio.setSample (0, i, s);
+            audio.setSample (1, i, s);
+        }
+
+        WavAudioFormat wav;
+        std::unique_ptr<FileOutputStream> stream (file.createOutputStream());
+        if (stream == nullptr) return {};
+
+        std::unique_ptr<AudioFormatWriter> writer (wav.createWriterFor (stream.get(), sampleRate, 2, 16, {}, 0));
+        if (writer == nullptr) return {};
+
+        stream.release();
+        writer->writeFromAudioSampleBuffer (audio, 0, numSamples);
+        return file;
+    }
+
+    BenchResult runConfig (AudioFormatManager& formatManager, const Array<File>& tracks,
+                           const BenchConfig& config, double secondsToRender)
+    {
+        DJMixer mixer (formatManager, config.numDecks);
+
+        for (int i = 0; i < mixer.getNumDecks(); ++i)
+        {
+            auto& deck = mixer.getDeck (i);
+            deck.loadURL (URL (tracks[i % tracks.size()]), true);
+            deck.setGain (0.8);
+            deck.setSpeed (config.speed);
+
+            if (config.eqBoost)
+            {
+                deck.setLowEQGainDb (6.0f);
+                deck.setMidEQGainDb (-3.0f);
+                deck.setHighEQGainDb (9.0f);
+            }
+
+            deck.getSpectrum().setEnabled (config.spectrum);
+            deck.start();
+        }
+
+        mixer.getMasterSpectrum().setEnabled (config.spectrum);
+
+        FakeAudioDevice device (config.blockSize, config.sampleRate);
+        return device.run (mixer, secondsToRender);
+    }
+
+    /** Render a control log twice and check the two mixes match sample for sample */
+    bool checkDeterminism (AudioFormatManager& formatManager, const File& logFile, int blockSize)
+    {
+        ControlLog log;
+        if (! log.loadFromFile (logFile))
+        {
+            std::cerr << "Could not read control log " << logFile.getFullPathName() << std::endl;
+            return false;
+        }
+
+        OfflineMixRenderer renderer (formatManager);
+        AudioBuffer<float> first, second;
+
+        for (auto* destination : { &first, &second })
+        {
+            const auto result = renderer.renderToBuffer (log, *destination, blockSize);
+            if (result.failed())
+            {
+                std::cerr << result.getErrorMessage() << std::endl;
+                return false;
+            }
+        }
+
+        for (int ch = 0; ch < first.getNumChannels(); ++ch)
+        {
+            const auto* a = first.getReadPointer (ch);
+            const auto* b = second.getReadPointer (ch);
+
+            for (int i = 0; i < first.getNumSamples(); ++i)
+            {
+                if (std::memcmp (a + i, b + i, sizeof (float)) != 0)
+                {
+                    std::cerr << "Renders differ on channel " << ch << " at sample " << i
+                              << " (" << a[i] << " vs " << b[i] << ")" << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        std::cout << "Two renders of " << first.getNumSamples() << " samples at block size "
+                  << blockSize << " are identical" << std::endl;
+        return true;
+    }
+
+    Array<int> parseIntList (const String& text, Array<int> fallback)
+    {
+        if (text.isEmpty()) return fallback;
+
+        Array<int> result;
+        for (auto& token : StringArray::fromTokens (text, ",", {}))
+            if (token.getIntValue() > 0)
+                result.add (token.getIntValue());
+
+        return result.isEmpty() ? fallback : result;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    ArgumentList args (argc, argv);
+
+    const bool quick = args.containsOption ("--quick");
+    const bool spectrum = args.containsOption ("--spectrum");
+    const double seconds = args.containsOption ("--seconds")
+                               ? jmax (0.5, args.getValueForOption ("--seconds").getDoubleValue())
+                               : (quick ? 2.0 : 5.0);
+
+    const auto deckCounts  = parseIntList (args.getValueForOption ("--decks"),
+                                           quick ? Array<int> { 2 } : Array<int> { 1, 2, 4 });
+    const auto blockSizes  = parseIntList (args.getValueForOption ("--blocks"),
+                                           quick ? Array<int> { 64, 512 }
+                                                 : Array<int> { 32, 64, 128, 256, 512, 1024, 2048 });
+    const auto sampleRates = parseIntList (args.getValueForOption ("--rates"),
+                                           quick ? Array<int> { 44100 } : Array<int> { 44100, 48000, 96000 });
+    const Array<double> speeds = quick ? Array<double> { 1.0, 1.08 } : Array<double> { 1.0, 0.92, 1.08 };
+    const Array<bool> eqSettings { false, true };
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    if (args.containsOption ("--determinism"))
+    {
+        const auto logFile = File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--determinism"));
+        const int blockSize = args.containsOption ("--blocks") ? blockSizes.getFirst() : 512;
+        return checkDeterminism (formatManager, logFile, blockSize) ? 0 : 1;
+    }
+
+    // Any readable audio file on the command line is part of the corpus
+    Array<File> corpus;
+    for (auto& arg : args.arguments)
+    {
+        if (arg.isOption()) continue;
+
+        auto f = arg.resolveAsFile();
+        if (f.existsAsFile() && formatManager.findFormatForFileExtension (f.getFileExtension()) != nullptr)
+            corpus.add (f);
+    }
+
+    std::unique_ptr<FileOutputStream> csv;
+    if (args.containsOption ("--csv"))
+    {
+        auto csvFile = File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--csv"));
+        csvFile.deleteFile();
+        csv = csvFile.createOutputStream();
+
+        if (csv != nullptr)
+            csv->writeText ("decks,block,rate,speed,eq,ns_per_sample,mean_us,p99_us,max_us,allocs_per_callback,realtime_x,underruns\n",
+                            false, false, nullptr);
+    }
+
+    std::cout << "OtoDecks engine benchmark ("
+              << (corpus.isEmpty() ? String ("synthetic tracks") : String (corpus.size()) + " corpus files")
+              << ", " << seconds << " s per run)" << std::endl;
+
+    std::cout << std::setw (5) << "decks" << std::setw (7) << "block" << std::setw (8) << "rate"
+              << std::setw (7) << "speed" << std::setw (5) << "eq"
+              << std::setw (11) << "ns/sample" << std::setw (10) << "mean us"
+              << std::setw (10) << "p99 us" << std::setw (10) << "max us"
+              << std::setw (12) << "allocs/cb" << std::setw (10) << "x rt" << std::setw (10) << "underruns" << std::endl;
+
+    double worstBudgetRatio = 0.0;
+    int totalUnderruns = 0;
+
+    for (auto rate : sampleRates)
+    {
+        Array<File> tracks = corpus;
+        if (tracks.isEmpty())
+        {
+            auto synthetic = createSyntheticTrack ((double) rate, 20.0);
+            if (synthetic == File{})
+            {
+                std::cerr << "Could not create a synthetic test track" << std::endl;
+                return 1;
+            }
+
+            tracks.add (synthetic);
+        }
+
+        for (auto decks : deckCounts)
+          for (auto block : blockSizes)
+            for (auto speed : speeds)
+              for (auto eq : eqSettings)
+              {
+                  BenchConfig config;
+                  config.numDecks = decks;
+                  config.blockSize = block;
+                  config.sampleRate = (double) rate;
+                  config.speed = speed;
+                  config.eqBoost = eq;
+                  config.spectrum = spectrum;
+
+                  const auto r = runConfig (formatManager, tracks, config, seconds);
+
+                  std::cout << std::fixed << std::setprecision (2)
+                            << std::setw (5) << decks << std::setw (7) << block << std::setw (8) << rate
+                            << std::setw (7) << speed << std::setw (5) << (eq ? "on" : "off")
+                            << std::setw (11) << r.nsPerSample << std::setw (10) << r.meanCallbackUs
+                            << std::setw (10) << r.p99CallbackUs << std::setw (10) << r.maxCallbackUs
+                            << std::setw (12) << r.allocationsPerCallback
+                            << std::setw (10) << std::setprecision (1) << r.realtimeFactor
+                            << std::setw (10) << r.underruns << std::endl;
+
+                  if (csv != nullptr)
+                      csv->writeText (String (decks) + "," + String (block) + "," + String (rate) + ","
+                                        + String (speed, 2) + "," + (eq ? "1" : "0") + ","
+                                        + String (r.nsPerSample, 3) + "," + String (r.meanCallbackUs, 3) + ","
+                                        + String (r.p99CallbackUs, 3) + "," + String (r.maxCallbackUs, 3) + ","
+                                        + String (r.allocationsPerCallback, 3) + ","
+                                        + String (r.realtimeFactor, 2) + "," + String (r.underruns) + "\n",
+                                      false, false, nullptr);
+
+                  const double budgetUs = 1.0e6 * block / rate;
+                  worstBudgetRatio = jmax (worstBudgetRatio, r.p99CallbackUs / budgetUs);
+                  totalUnderruns += r.underruns;
+              }
+    }
+
+    std::cout << "Worst p99 callback used " << std::setprecision (1) << (worstBudgetRatio * 100.0)
+              << "% of its real-time budget" << std::endl;
+
+    // Timings from blocks the disk couldn't keep up with are not timings of the engine
+    if (totalUnderruns > 0)
+    {
+        std::cerr << totalUnderruns << " blocks found their read-ahead empty; the results are not valid" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
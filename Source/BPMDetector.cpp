@@ -151,3 +151,67 @@ double BPMDetector::detectBpmFromBuffer(const juce::AudioBuffer<float>& buffer,
 
     return bpm;
 }
+
+double BPMDetector::detectFirstBeatSec(const juce::AudioBuffer<float>& buffer,
+                                       double sampleRate,
+                                       double bpm)
+{
+    const int numCh = buffer.getNumChannels();
+    const int numSamp = buffer.getNumSamples();
+    if (numCh <= 0 || numSamp <= 0 || sampleRate <= 0.0 || bpm <= 0.0) return 0.0;
+
+    // Same hop-based energy envelope as detectBpmFromBuffer, but using a
+    // shorter window so onsets are located more precisely.
+    const int win = 512;
+    const int hop = 256;
+    if (numSamp < win + hop) return 0.0;
+
+    const int envLen = 1 + (numSamp - win) / hop;
+    std::vector<float> env ((size_t) envLen, 0.0f);
+
+    for (int frame = 0; frame < envLen; ++frame)
+    {
+        const int start = frame * hop;
+        double sumSq = 0.0;
+
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            auto* x = buffer.getReadPointer(ch, start);
+            for (int i = 0; i < win; ++i)
+                sumSq += (double) x[i] * (double) x[i];
+        }
+
+        env[(size_t) frame] = (float) std::sqrt(sumSq / (double) (win * numCh));
+    }
+
+    // Onset strength: positive change in energy
+    std::vector<float> flux ((size_t) envLen, 0.0f);
+    for (int i = 1; i < envLen; ++i)
+        flux[(size_t) i] = std::max(0.0f, env[(size_t) i] - env[(size_t) (i - 1)]);
+
+    // Fold the onsets onto one beat period and pick the strongest phase
+    const double envRate = sampleRate / (double) hop;
+    const double periodFrames = envRate * 60.0 / bpm;
+    const int numPhases = std::max(1, (int) std::floor(periodFrames));
+
+    int bestPhase = 0;
+    double bestScore = 0.0;
+
+    for (int phase = 0; phase < numPhases; ++phase)
+    {
+        double score = 0.0;
+        for (double pos = phase; pos < (double) envLen; pos += periodFrames)
+            score += flux[(size_t) pos];
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestPhase = phase;
+        }
+    }
+
+    if (bestScore <= 0.0) return 0.0;
+
+    // Centre of the analysis window of the winning frame
+    return ((double) bestPhase * hop + win * 0.5) / sampleRate;
+}
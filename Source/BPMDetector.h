@@ -20,4 +20,11 @@ public:
                                      double sampleRate,
                                      double minBpm = 70.0,
                                      double maxBpm = 200.0);
+
+    /** Estimate where the first beat of the beat grid falls, in seconds from
+        the start of the buffer, for an already detected tempo.
+        Returns 0.0 if no clear onset pattern is found. */
+    static double detectFirstBeatSec(const juce::AudioBuffer<float>& buffer,
+                                     double sampleRate,
+                                     double bpm);
 };
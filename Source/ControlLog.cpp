@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+    ControlLog.cpp
+    Created: 18 Oct 2026 10:02:41am
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "ControlLog.h"
+#include <algorithm>
+
+void ControlLog::startRecording (const std::atomic<int64>& sampleClock, double rate, int decks)
+{
+    const ScopedLock sl (lock);
+
+    events.clear();
+    clock = &sampleClock;
+    startSample = sampleClock.load();
+    lengthInSamples = 0;
+    sampleRate = rate;
+    numDecks = jmax (1, decks);
+}
+
+void ControlLog::stopRecording()
+{
+    const ScopedLock sl (lock);
+
+    if (clock == nullptr) return;
+
+    lengthInSamples = clock->load() - startSample;
+    clock = nullptr;
+}
+
+bool ControlLog::isRecording() const
+{
+    const ScopedLock sl (lock);
+    return clock != nullptr;
+}
+
+void ControlLog::record (int deck, EventType type, double value, const String& path,
+                         int64 mixerSample)
+{
+    const ScopedLock sl (lock);
+
+    if (clock == nullptr) return;
+
+    Event e;
+    const auto now = clock->load();
+    e.sampleTime = jmax ((int64) 0, jmax (now, mixerSample) - startSample);
+    e.deck = deck;
+    e.type = type;
+    e.value = value;
+    e.path = path;
+
+    events.push_back (e);
+}
+
+void ControlLog::addEvent (const Event& event)
+{
+    const ScopedLock sl (lock);
+
+    events.push_back (event);
+    lengthInSamples = jmax (lengthInSamples, event.sampleTime);
+}
+
+void ControlLog::clear()
+{
+    const ScopedLock sl (lock);
+
+    events.clear();
+    lengthInSamples = 0;
+}
+
+std::vector<ControlLog::Event> ControlLog::getEvents() const
+{
+    std::vector<Event> result;
+
+    {
+        const ScopedLock sl (lock);
+        result = events;
+    }
+
+    // Events recorded from the message thread are already in order, but logs
+    // built in code or edited by hand may not be.
+    std::stable_sort (result.begin(), result.end(),
+                      [] (const Event& a, const Event& b) { return a.sampleTime < b.sampleTime; });
+    return result;
+}
+
+int64 ControlLog::getLengthInSamples() const
+{
+    const ScopedLock sl (lock);
+
+    if (clock != nullptr)
+        return clock->load() - startSample;
+
+    return lengthInSamples;
+}
+
+void ControlLog::setLengthInSamples (int64 numSamples)
+{
+    const ScopedLock sl (lock);
+    lengthInSamples = jmax ((int64) 0, numSamples);
+}
+
+//==============================================================================
+
+String ControlLog::getTypeName (EventType type)
+{
+    switch (type)
+    {
+        case EventType::load:   return "load";
+        case EventType::play:   return "play";
+        case EventType::stop:   return "stop";
+        case EventType::seek:   return "seek";
+        case EventType::speed:  return "speed";
+        case EventType::gain:   return "gain";
+        case EventType::lowEQ:  return "lowEQ";
+        case EventType::midEQ:  return "midEQ";
+        case EventType::highEQ: return "highEQ";
+        case EventType::loopIn:     return "loopIn";
+        case EventType::loopOut:    return "loopOut";
+        case EventType::beatLoop:   return "beatLoop";
+        case EventType::loopHalve:  return "loopHalve";
+        case EventType::loopDouble: return "loopDouble";
+        case EventType::loopExit:   return "loopExit";
+        case EventType::slip:       return "slip";
+        case EventType::sync:       return "sync";
+        case EventType::filter:     return "filter";
+        case EventType::flanger:    return "flanger";
+        case EventType::echo:       return "echo";
+        case EventType::reverbSend: return "reverbSend";
+        case EventType::impulse:    return "impulse";
+        case EventType::scratch:    return "scratch";
+        case EventType::scratchRate: return "scratchRate";
+    }
+
+    return {};
+}
+
+bool ControlLog::getTypeFromName (const String& name, EventType& result)
+{
+    for (auto t : { EventType::load, EventType::play, EventType::stop, EventType::seek,
+                    EventType::speed, EventType::gain, EventType::lowEQ, EventType::midEQ,
+                    EventType::highEQ, EventType::loopIn, EventType::loopOut, EventType::beatLoop,
+                    EventType::loopHalve, EventType::loopDouble, EventType::loopExit, EventType::slip,
+                    EventType::sync, EventType::filter, EventType::flanger, EventType::echo,
+                    EventType::reverbSend, EventType::impulse, EventType::scratch,
+                    EventType::scratchRate })
+    {
+        if (getTypeName (t) == name)
+        {
+            result = t;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ControlLog::saveToFile (const File& file) const
+{
+    DynamicObject::Ptr root = new DynamicObject();
+    Array<var> arr;
+
+    {
+        const ScopedLock sl (lock);
+
+        root->setProperty ("sampleRate", sampleRate);
+        root->setProperty ("numDecks", numDecks);
+        root->setProperty ("length", lengthInSamples);
+
+        for (auto& e : events)
+        {
+            DynamicObject::Ptr obj = new DynamicObject();
+            obj->setProperty ("t", e.sampleTime);
+            obj->setProperty ("deck", e.deck);
+            obj->setProperty ("type", getTypeName (e.type));
+            obj->setProperty ("value", e.value);
+
+            if (e.path.isNotEmpty())
+                obj->setProperty ("path", e.path);
+
+            arr.add (var (obj.get()));
+        }
+    }
+
+    root->setProperty ("events", var (arr));
+    return file.replaceWithText (JSON::toString (var (root.get())));
+}
+
+bool ControlLog::loadFromFile (const File& file)
+{
+    if (! file.existsAsFile()) return false;
+
+    var parsed = JSON::parse (file.loadFileAsString());
+    auto* root = parsed.getDynamicObject();
+    if (root == nullptr) return false;
+
+    auto* arr = root->getProperty ("events").getArray();
+    if (arr == nullptr) return false;
+
+    std::vector<Event> loaded;
+
+    for (auto& item : *arr)
+    {
+        auto* obj = item.getDynamicObject();
+        if (obj == nullptr) continue;
+
+        Event e;
+        if (! getTypeFromName (obj->getProperty ("type").toString(), e.type)) continue;
+
+        e.sampleTime = (int64) obj->getProperty ("t");
+        e.deck = (int) obj->getProperty ("deck");
+        e.value = (double) obj->getProperty ("value");
+        e.path = obj->getProperty ("path").toString();
+
+        loaded.push_back (e);
+    }
+
+    const ScopedLock sl (lock);
+
+    events = std::move (loaded);
+    clock = nullptr;
+    sampleRate = (double) root->getProperty ("sampleRate");
+    numDecks = jmax (1, (int) root->getProperty ("numDecks"));
+    lengthInSamples = (int64) root->getProperty ("length");
+
+    if (sampleRate <= 0.0)
+        sampleRate = 44100.0;
+
+    for (auto& e : events)
+        lengthInSamples = jmax (lengthInSamples, e.sampleTime);
+
+    return true;
+}
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    ControlLog.h
+    Created: 18 Oct 2026 10:02:41am
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+/** A list of deck control changes stamped with the mixer's sample clock.
+
+    While recording, every change is timestamped relative to the sample at
+    which recording started, so the log can be replayed offline through a
+    fresh mixer and produce exactly the same output.
+*/
+class ControlLog
+{
+public:
+    enum class EventType
+    {
+        load,
+        play,
+        stop,
+        seek,       // value = position in seconds
+        speed,
+        gain,
+        lowEQ,      // value = gain in dB
+        midEQ,
+        highEQ,
+        loopIn,
+        loopOut,
+        beatLoop,   // value = loop length in beats
+        loopHalve,
+        loopDouble,
+        loopExit,
+        slip,       // value = 1 for on, 0 for off
+        sync,       // value = 1 for on, 0 for off
+        filter,     // value = knob position, -1 to 1
+        flanger,    // value = amount, 0 to 1
+        echo,
+        reverbSend, // value = send level, 0 to 1
+        impulse,    // mixer-wide (deck -1), path = impulse response file
+        scratch,    // value = 1 for hand on the platter, 0 for off
+        scratchRate // value = platter speed, negative = backwards
+    };
+
+    struct Event
+    {
+        int64 sampleTime = 0;   // samples since the start of the recording
+        int deck = 0;
+        EventType type = EventType::play;
+        double value = 0.0;
+        String path;            // URL of the track, for load events only
+    };
+
+    ControlLog() = default;
+
+    /** Start timestamping events against the given mixer clock */
+    void startRecording (const std::atomic<int64>& sampleClock, double sampleRate, int numDecks);
+    /** Stop recording, fixing the length of the log at the current clock */
+    void stopRecording();
+    /** Check whether events are currently being recorded */
+    bool isRecording() const;
+
+    /** Timestamp and store a control change (ignored when not recording).
+        A positive mixerSample stamps the event at that clock sample instead
+        of now, for changes scheduled ahead on the audio thread. */
+    void record (int deck, EventType type, double value, const String& path = {},
+                 int64 mixerSample = 0);
+    /** Append an event with an explicit timestamp, e.g. when building a log in code */
+    void addEvent (const Event& event);
+    /** Remove all events */
+    void clear();
+
+    /** Return a copy of the events, sorted by sample time */
+    std::vector<Event> getEvents() const;
+    /** Total length of the recording in samples */
+    int64 getLengthInSamples() const;
+    /** Set the total length explicitly (for logs built in code) */
+    void setLengthInSamples (int64 numSamples);
+
+    double getSampleRate() const  { return sampleRate; }
+    void setSampleRate (double newRate)  { sampleRate = newRate; }
+    int getNumDecks() const  { return numDecks; }
+    void setNumDecks (int newNumDecks)  { numDecks = jmax (1, newNumDecks); }
+
+    /** Write the log to a JSON file */
+    bool saveToFile (const File& file) const;
+    /** Replace the contents of this log with a JSON file written by saveToFile() */
+    bool loadFromFile (const File& file);
+
+    static String getTypeName (EventType type);
+    static bool getTypeFromName (const String& name, EventType& result);
+
+private:
+    mutable CriticalSection lock;
+
+    std::vector<Event> events;
+    const std::atomic<int64>* clock = nullptr;
+    int64 startSample = 0;
+    int64 lengthInSamples = 0;
+    double sampleRate = 44100.0;
+    int numDecks = 2;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ControlLog)
+};
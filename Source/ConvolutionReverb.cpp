@@ -0,0 +1,540 @@
+/*
+  ==============================================================================
+
+    ConvolutionReverb.cpp
+    Created: 18 Oct 2026 6:02:37pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "ConvolutionReverb.h"
+
+//==============================================================================
+/** Uniformly partitioned overlap-save convolution of up to two channels with
+    one segment of an impulse response. Everything is allocated up front. */
+class ConvolutionReverb::Convolver
+{
+public:
+    /** Partition ir[offset, offset + length) into blocks of partitionSize samples */
+    Convolver(const AudioBuffer<float>& ir, int offset, int length, int blockSize)
+        : partitionSize(blockSize),
+          numBins(blockSize + 1),
+          numPartitions(jmax(1, (length + blockSize - 1) / blockSize)),
+          irChannels(jmax(1, ir.getNumChannels())),
+          fft(roundToInt(std::log2(2 * blockSize)))
+    {
+        const int stride = 2 * numBins;
+
+        irSpectra.assign((size_t) (irChannels * numPartitions * stride), 0.0f);
+        spectra.assign((size_t) (2 * numPartitions * stride), 0.0f);
+        overlap.assign((size_t) (2 * partitionSize), 0.0f);
+        work.assign((size_t) (4 * partitionSize), 0.0f);
+
+        for (int ch = 0; ch < irChannels; ++ch)
+        {
+            for (int p = 0; p < numPartitions; ++p)
+            {
+                std::fill(work.begin(), work.end(), 0.0f);
+
+                const int start = offset + p * partitionSize;
+                const int count = jmin(partitionSize, offset + length - start);
+                if (count > 0)
+                    FloatVectorOperations::copy(work.data(), ir.getReadPointer(ch, start), count);
+
+                fft.performRealOnlyForwardTransform(work.data(), true);
+                std::copy(work.begin(), work.begin() + stride,
+                          irSpectra.begin() + (ch * numPartitions + p) * stride);
+            }
+        }
+    }
+
+    /** Convolve exactly one partition of new input per channel */
+    void process(const float* const* input, float* const* output, int numChannels)
+    {
+        const int n = partitionSize;
+        const int stride = 2 * numBins;
+        float* w = work.data();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* previous = overlap.data() + ch * n;
+            auto* delayLine = spectra.data() + ch * numPartitions * stride;
+
+            // Transform [previous block | new block] into the frequency-domain delay line
+            FloatVectorOperations::copy(w, previous, n);
+            FloatVectorOperations::copy(w + n, input[ch], n);
+            FloatVectorOperations::clear(w + 2 * n, 2 * n);
+            FloatVectorOperations::copy(previous, input[ch], n);
+
+            fft.performRealOnlyForwardTransform(w, true);
+            FloatVectorOperations::copy(delayLine + current * stride, w, stride);
+
+            // Multiply each partition of the response with the block it
+            // lines up with and sum the products
+            FloatVectorOperations::clear(w, 4 * n);
+            const auto* response = irSpectra.data() + (ch % irChannels) * numPartitions * stride;
+
+            for (int p = 0; p < numPartitions; ++p)
+            {
+                int slot = current - p;
+                if (slot < 0) slot += numPartitions;
+
+                const auto* x = delayLine + slot * stride;
+                const auto* h = response + p * stride;
+
+                for (int b = 0; b < stride; b += 2)
+                {
+                    w[b]     += x[b] * h[b]     - x[b + 1] * h[b + 1];
+                    w[b + 1] += x[b] * h[b + 1] + x[b + 1] * h[b];
+                }
+            }
+
+            // The second half of the circular result is the valid output
+            fft.performRealOnlyInverseTransform(w);
+            FloatVectorOperations::copy(output[ch], w + n, n);
+        }
+
+        current = (current + 1) % numPartitions;
+    }
+
+private:
+    const int partitionSize, numBins, numPartitions, irChannels;
+    dsp::FFT fft;
+
+    std::vector<float> irSpectra;   // [irChannel][partition][bin], interleaved complex
+    std::vector<float> spectra;     // past input blocks, [channel][slot][bin]
+    std::vector<float> overlap;     // last input block, per channel
+    std::vector<float> work;        // FFT scratch, twice the FFT size
+    int current = 0;
+};
+
+//==============================================================================
+/** One prepared impulse response with all of its convolution state, swapped
+    in and out as a unit. The head is convolved on the audio thread; the tail
+    starts tailOffset samples into the response and is convolved by whoever
+    calls processTail(). */
+struct ConvolutionReverb::Engine
+{
+    Engine(const AudioBuffer<float>& ir, int headBlockSize, int tailBlockSize)
+        : headSize(headBlockSize), tailSize(tailBlockSize), tailOffset(2 * tailBlockSize)
+    {
+        for (auto& r : tailReady)
+            r = -1;
+
+        const int length = ir.getNumSamples();
+        if (length == 0) return;
+
+        head = std::make_unique<Convolver>(ir, 0, jmin(length, tailOffset), headSize);
+
+        if (length > tailOffset)
+            tail = std::make_unique<Convolver>(ir, tailOffset, length - tailOffset, tailSize);
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            headInput[ch].assign((size_t) headSize, 0.0f);
+            headOutput[ch].assign((size_t) headSize, 0.0f);
+
+            if (tail != nullptr)
+            {
+                tailInput[ch].assign((size_t) (tailSize * numTailSlots), 0.0f);
+                tailOutput[ch].assign((size_t) (tailSize * numTailSlots), 0.0f);
+            }
+        }
+    }
+
+    /** Convolve a block of the send in place. Returns true if a tail partition
+        was due but not ready. */
+    bool process(AudioBuffer<float>& buffer, int numSamples, bool computeTailHere)
+    {
+        if (head == nullptr)
+        {
+            buffer.clear(0, numSamples);
+            return false;
+        }
+
+        const int numChannels = jmin(2, buffer.getNumChannels());
+        bool late = false;
+
+        for (int done = 0; done < numSamples;)
+        {
+            // Work up to the next head partition boundary, which is also
+            // where tail partitions start and end
+            const int headPos = (int) (inputCount % headSize);
+            const int count = jmin(numSamples - done, headSize - headPos);
+
+            const int64 tailIndex = inputCount - headSize - tailOffset;
+            const int64 chunk = tailIndex >= 0 ? tailIndex / tailSize : -1;
+            const int slot = (int) (jmax((int64) 0, chunk) % numTailSlots);
+            const bool tailDue = tail != nullptr && chunk >= 0;
+            const bool tailAvailable = tailDue && tailReady[slot].load(std::memory_order_acquire) == chunk;
+
+            if (tailDue && ! tailAvailable && tailIndex % tailSize == 0)
+                late = true;
+
+            const int tailWritePos = (int) (inputCount % (tailSize * numTailSlots));
+            const int tailReadPos = slot * tailSize + (int) (jmax((int64) 0, tailIndex) % tailSize);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* io = buffer.getWritePointer(ch, done);
+
+                FloatVectorOperations::copy(headInput[ch].data() + headPos, io, count);
+                if (tail != nullptr)
+                    FloatVectorOperations::copy(tailInput[ch].data() + tailWritePos, io, count);
+
+                FloatVectorOperations::copy(io, headOutput[ch].data() + headPos, count);
+                if (tailAvailable)
+                    FloatVectorOperations::add(io, tailOutput[ch].data() + tailReadPos, count);
+            }
+
+            done += count;
+            inputCount += count;
+
+            if (headPos + count == headSize)
+            {
+                const float* in[2] = { headInput[0].data(), headInput[1].data() };
+                float* out[2] = { headOutput[0].data(), headOutput[1].data() };
+                head->process(in, out, numChannels);
+            }
+
+            if (tail != nullptr && inputCount % tailSize == 0)
+            {
+                tailSubmitted.store(inputCount / tailSize, std::memory_order_release);
+
+                if (computeTailHere)
+                    processTail();
+            }
+        }
+
+        return late;
+    }
+
+    /** Convolve every tail partition submitted so far. Returns false if there
+        was nothing to do. */
+    bool processTail()
+    {
+        if (tail == nullptr) return false;
+
+        const int64 submitted = tailSubmitted.load(std::memory_order_acquire);
+        if (tailProcessed >= submitted) return false;
+
+        // Fallen so far behind that the oldest input is being overwritten:
+        // skip to the newest partition
+        if (submitted - tailProcessed > numTailSlots - 2)
+            tailProcessed = submitted - 1;
+
+        for (; tailProcessed < submitted; ++tailProcessed)
+        {
+            const int offset = (int) (tailProcessed % numTailSlots) * tailSize;
+            const float* in[2] = { tailInput[0].data() + offset, tailInput[1].data() + offset };
+            float* out[2] = { tailOutput[0].data() + offset, tailOutput[1].data() + offset };
+
+            tail->process(in, out, 2);
+            tailReady[tailProcessed % numTailSlots].store(tailProcessed, std::memory_order_release);
+        }
+
+        return true;
+    }
+
+    static constexpr int numTailSlots = 4;
+
+    const int headSize, tailSize, tailOffset;
+    std::unique_ptr<Convolver> head, tail;
+
+    // Audio thread only
+    std::vector<float> headInput[2], headOutput[2];
+    int64 inputCount = 0;
+
+    // Shared with the tail thread: the audio thread writes input for
+    // partition j into slot j % numTailSlots and reads the result back
+    // two partitions later, once tailReady[slot] says it is there
+    std::vector<float> tailInput[2], tailOutput[2];
+    std::atomic<int64> tailSubmitted { 0 };
+    std::atomic<int64> tailReady[numTailSlots];
+    int64 tailProcessed = 0;
+};
+
+//==============================================================================
+namespace
+{
+    /** Resample a response to the device rate, trim it, and scale it to unit
+        energy so a send at full level comes back at about the same loudness */
+    AudioBuffer<float> conformResponse(const AudioBuffer<float>& source, double sourceRate,
+                                       double targetRate, double maxSeconds)
+    {
+        const double ratio = sourceRate / targetRate;
+        const int numChannels = jmin(2, source.getNumChannels());
+        const int length = jmin((int) (maxSeconds * targetRate),
+                                (int) std::floor(source.getNumSamples() / ratio));
+
+        AudioBuffer<float> result(numChannels, jmax(0, length));
+        if (length <= 0) return result;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            LagrangeInterpolator interpolator;
+            interpolator.process(ratio, source.getReadPointer(ch), result.getWritePointer(ch),
+                                 length, source.getNumSamples(), 0);
+        }
+
+        // Fade out the last 10 ms in case the response was cut short
+        const int fade = jmin(length, (int) (0.01 * targetRate));
+        result.applyGainRamp(length - fade, fade, 1.0f, 0.0f);
+
+        float energy = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* d = result.getReadPointer(ch);
+            float sum = 0.0f;
+            for (int i = 0; i < length; ++i)
+                sum += d[i] * d[i];
+            energy = jmax(energy, sum);
+        }
+
+        if (energy > 0.0f)
+            result.applyGain(1.0f / std::sqrt(energy));
+
+        return result;
+    }
+}
+
+ConvolutionReverb::ConvolutionReverb()
+    : Thread("Reverb tail")
+{
+    startThread(Thread::Priority::high);
+}
+
+ConvolutionReverb::~ConvolutionReverb()
+{
+    loaderPool.removeAllJobs(true, 10000);
+    stopThread(2000);
+
+    delete pendingEngine.exchange(nullptr);
+    for (auto& slot : retiredEngines)
+        delete slot.exchange(nullptr);
+}
+
+void ConvolutionReverb::prepare(double newSampleRate, int maximumBlockSize)
+{
+    // Let any load in flight finish against the old settings first
+    loaderPool.removeAllJobs(true, 10000);
+
+    {
+        const ScopedLock sl(irLock);
+        sampleRate = newSampleRate;
+        headSize = jlimit(64, 1024, nextPowerOfTwo(jmax(1, maximumBlockSize)));
+    }
+
+    auto fresh = buildEngine();
+
+    // The audio thread is stopped, so everything can be replaced directly;
+    // only the worker has to be out of the way
+    activeEngine.store(nullptr);
+    while (workerEngine.load() != nullptr)
+        Thread::sleep(1);
+
+    delete pendingEngine.exchange(nullptr);
+    for (auto& slot : retiredEngines)
+        delete slot.exchange(nullptr);
+    deferredRetire.reset();
+
+    engine = std::move(fresh);
+    activeEngine.store(engine.get());
+}
+
+void ConvolutionReverb::process(AudioBuffer<float>& buffer, int numSamples)
+{
+    if (numSamples <= 0) return;
+
+    // The worker frees whatever has been retired once it wakes
+    if (deferredRetire != nullptr && retireEngine(deferredRetire))
+        notify();
+
+    if (engine == nullptr)
+        adoptPendingEngine();
+
+    if (engine == nullptr)
+    {
+        buffer.clear(0, numSamples);
+        return;
+    }
+
+    // A new response fades the old one out over this block and takes over
+    // from the next; it starts from silence, so it needs no fade in
+    const bool swapping = pendingEngine.load(std::memory_order_acquire) != nullptr
+                          && deferredRetire == nullptr;
+    const bool computeTailHere = nonRealtime.load(std::memory_order_relaxed);
+    const int64 submitted = engine->tailSubmitted.load(std::memory_order_relaxed);
+
+    if (engine->process(buffer, numSamples, computeTailHere))
+        ++lateTailCount;
+
+    // Wake the worker only when there is a tail partition for it
+    if (! computeTailHere && engine->tailSubmitted.load(std::memory_order_relaxed) != submitted)
+        notify();
+
+    if (swapping)
+    {
+        buffer.applyGainRamp(0, numSamples, 1.0f, 0.0f);
+        adoptPendingEngine();
+        notify();
+    }
+}
+
+void ConvolutionReverb::loadImpulseResponse(const File& file, AudioFormatManager& formatManager,
+                                            bool waitUntilLoaded)
+{
+    auto load = [this, file, &formatManager]
+    {
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->sampleRate <= 0.0 || reader->lengthInSamples <= 0)
+            return false;
+
+        const int length = (int) jmin(reader->lengthInSamples,
+                                      (int64) (maxResponseSeconds * reader->sampleRate));
+        const int numChannels = jlimit(1, 2, (int) reader->numChannels);
+
+        AudioBuffer<float> audio(numChannels, length);
+        reader->read(&audio, 0, length, 0, true, numChannels > 1);
+
+        {
+            const ScopedLock sl(irLock);
+            irAudio = std::move(audio);
+            irSampleRate = reader->sampleRate;
+            irFile = file;
+        }
+
+        handOverEngine(buildEngine());
+        return true;
+    };
+
+    if (waitUntilLoaded)
+    {
+        loaderPool.removeAllJobs(true, 10000);
+        load();
+        return;
+    }
+
+    loaderPool.addJob([load] { load(); });
+}
+
+void ConvolutionReverb::clearImpulseResponse()
+{
+    loaderPool.addJob([this]
+    {
+        {
+            const ScopedLock sl(irLock);
+            irAudio.setSize(0, 0);
+            irSampleRate = 0.0;
+            irFile = File();
+        }
+
+        handOverEngine(buildEngine());
+    });
+}
+
+File ConvolutionReverb::getImpulseResponseFile() const
+{
+    const ScopedLock sl(irLock);
+    return irFile;
+}
+
+std::unique_ptr<ConvolutionReverb::Engine> ConvolutionReverb::buildEngine()
+{
+    const ScopedLock sl(irLock);
+
+    const int tailSize = headSize * tailPartitionRatio;
+
+    if (irAudio.getNumSamples() == 0 || irSampleRate <= 0.0)
+        return std::make_unique<Engine>(AudioBuffer<float>(), headSize, tailSize);
+
+    const auto response = conformResponse(irAudio, irSampleRate, sampleRate, maxResponseSeconds);
+    return std::make_unique<Engine>(response, headSize, tailSize);
+}
+
+void ConvolutionReverb::handOverEngine(std::unique_ptr<Engine> next)
+{
+    // Take back an engine the audio thread never picked up, and the ones it
+    // has swapped out, so the hand-over slots are empty again
+    std::unique_ptr<Engine> unused(pendingEngine.exchange(nullptr));
+    for (auto& slot : retiredEngines)
+        deleteEngine(slot.exchange(nullptr));
+
+    pendingEngine.store(next.release());
+}
+
+void ConvolutionReverb::adoptPendingEngine()
+{
+    // Until the last engine swapped out has somewhere to go, nothing else is
+    // swapped in; the loader empties the slots on every hand-over
+    if (deferredRetire != nullptr && ! retireEngine(deferredRetire))
+        return;
+
+    std::unique_ptr<Engine> next(pendingEngine.exchange(nullptr));
+    if (next == nullptr) return;
+
+    activeEngine.store(next.get());
+    std::swap(engine, next);
+
+    // Never overwrites a slot, so a hand-over racing this can't lose an engine
+    if (next != nullptr && ! retireEngine(next))
+        deferredRetire = std::move(next);
+}
+
+bool ConvolutionReverb::retireEngine(std::unique_ptr<Engine>& e)
+{
+    for (auto& slot : retiredEngines)
+    {
+        Engine* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, e.get()))
+        {
+            e.release();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ConvolutionReverb::deleteEngine(Engine* e)
+{
+    if (e == nullptr) return;
+
+    // The worker may still be finishing a partition with it
+    while (workerEngine.load() == e)
+        Thread::sleep(1);
+
+    delete e;
+}
+
+void ConvolutionReverb::run()
+{
+    while (! threadShouldExit())
+    {
+        bool worked = false;
+
+        // Free the engines process() has swapped out; it wakes this after a swap
+        for (auto& slot : retiredEngines)
+            deleteEngine(slot.exchange(nullptr));
+
+        if (! nonRealtime.load())
+        {
+            auto* e = activeEngine.load();
+            workerEngine.store(e);
+
+            // Check again after announcing it, so an engine that has just
+            // been replaced is never touched again
+            if (e != nullptr && activeEngine.load() == e)
+                worked = e->processTail();
+
+            workerEngine.store(nullptr);
+        }
+
+        // process() wakes this when it submits a tail partition, and
+        // stopThread() when it is time to go; with no response loaded, or
+        // rendering offline, it sleeps until then
+        if (! worked)
+            wait(-1);
+    }
+}
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    ConvolutionReverb.h
+    Created: 18 Oct 2026 6:02:37pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/** Convolution reverb on the mixer's send bus, using uniformly partitioned
+    FFT convolution.
+
+    The impulse response is split in two. Its head is convolved on the audio
+    thread in partitions the size of the device block; the rest uses
+    partitions eight times larger and is computed on a worker thread, which
+    gets a whole tail partition of slack before its output is due. The audio
+    thread's share therefore stays the same however long the response is.
+
+    Responses are read, resampled and transformed on a background thread and
+    swapped in without locking. The wet signal lags the send by one head
+    partition, which is heard as a few milliseconds of pre-delay.
+*/
+class ConvolutionReverb : private Thread
+{
+public:
+    ConvolutionReverb();
+    ~ConvolutionReverb() override;
+
+    /** Rebuild the convolvers for the device (not while processing) */
+    void prepare(double sampleRate, int maximumBlockSize);
+    /** Replace the send in channels 0 and 1 with the reverb's output (audio thread) */
+    void process(AudioBuffer<float>& buffer, int numSamples);
+
+    /** Read an impulse response from an audio file and swap it in once it has
+        been prepared. The current response stays if the file can't be read. */
+    void loadImpulseResponse(const File& file, AudioFormatManager& formatManager,
+                             bool waitUntilLoaded = false);
+    /** Remove the impulse response, silencing the reverb */
+    void clearImpulseResponse();
+    /** Return the file the current impulse response was read from */
+    File getImpulseResponseFile() const;
+
+    /** Compute the tail on the calling thread instead of the worker, for
+        rendering faster than real time (set before processing starts) */
+    void setNonRealtime(bool shouldBeNonRealtime) { nonRealtime = shouldBeNonRealtime; }
+
+    /** Return how far the wet signal lags the send, in samples */
+    int getLatencyInSamples() const { return headSize; }
+    /** Return how many tail partitions the worker finished too late to be heard */
+    int getLateTailCount() const { return lateTailCount.load(); }
+
+private:
+    class Convolver;
+    struct Engine;
+
+    void run() override;
+
+    std::unique_ptr<Engine> buildEngine();
+    void handOverEngine(std::unique_ptr<Engine> next);
+    void adoptPendingEngine();
+    bool retireEngine(std::unique_ptr<Engine>& e);
+    void deleteEngine(Engine* e);
+
+    static constexpr int tailPartitionRatio = 8;
+    static constexpr int numRetireSlots = 2;
+    static constexpr double maxResponseSeconds = 10.0;
+
+    double sampleRate = 44100.0;
+    int headSize = 512;
+
+    // The response as read from disk, kept so prepare() can rebuild it
+    CriticalSection irLock;
+    AudioBuffer<float> irAudio;
+    double irSampleRate = 0.0;
+    File irFile;
+
+    // Audio-thread state
+    std::unique_ptr<Engine> engine;
+
+    // Hand-over slots: the loader fills pendingEngine, the audio thread
+    // swaps it in and leaves the old engine in a free retired slot for the
+    // worker (or the next hand-over) to free. As with
+    // the decks' tracks, there are two so a hand-over racing a swap can't
+    // lose an engine; if both are full the old one waits in deferredRetire
+    // (audio thread only) and nothing more is swapped in until it has gone.
+    std::atomic<Engine*> pendingEngine { nullptr };
+    std::array<std::atomic<Engine*>, numRetireSlots> retiredEngines {};
+    std::unique_ptr<Engine> deferredRetire;
+
+    // The engine the worker may use, and the one it is using right now
+    std::atomic<Engine*> activeEngine { nullptr };
+    std::atomic<Engine*> workerEngine { nullptr };
+
+    std::atomic<bool> nonRealtime { false };
+    std::atomic<int> lateTailCount { 0 };
+
+    ThreadPool loaderPool { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConvolutionReverb)
+};
@@ -9,84 +9,317 @@
 
 #include "DJAudioPlayer.h"
 
+namespace
+{
+    // Resampler buffers are sized for this ratio up front (4x speed on a
+    // track at twice the device rate) so they never grow on the audio thread.
+    constexpr double maxResamplingRatio = 8.0;
+
+    // Length of the fade applied when a deck stops, to avoid a click
+    constexpr int stopFadeSamples = 256;
+
+    // Crossfade into a hot cue, out of a roll and across a loop's wrap
+    // point, in source samples
+    constexpr int crossfadeSamples = 256;
+
+    // Longest loop that can be held in RAM
+    constexpr double maxLoopSeconds = 16.0;
+
+    // How far ahead of the playhead the background thread decodes
+    constexpr double readAheadSeconds = 4.0;
+
+    // How much of a new track is decoded before it is handed to the audio thread
+    constexpr double primeSeconds = 0.5;
+
+    DeckCommand makeCommand(DeckCommand::Type type, double value, int64 targetSample = 0)
+    {
+        DeckCommand command;
+        command.type = type;
+        command.value = value;
+        command.targetSample = targetSample;
+        return command;
+    }
+}
+
 DJAudioPlayer::DJAudioPlayer(AudioFormatManager& _formatManager)
 : formatManager(_formatManager)
 {
+    hotCuePositions.fill(-1.0);
+    crossfadeTail.setSize(2, crossfadeSamples);
+    historyRing.setSize(2, crossfadeSamples);
+    historyRing.clear();
+    shadowScratch.setSize(2, 1024);
+    scratchFade.setSize(2, crossfadeSamples);
 }
 
 DJAudioPlayer::~DJAudioPlayer()
 {
+    loaderPool.removeAllJobs(true, 10000);
+
+    delete pendingTrack.exchange(nullptr);
+
+    RetiredTracks retired;
+    takeRetiredTracks(retired);
 }
 
 void DJAudioPlayer::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
     currentSampleRate = sampleRate;
+    preparedBlockSize = samplesPerBlockExpected;
+
+    // The audio thread isn't running yet, so pick up the latest control values
+    currentGain = (float) gainValue;
+    currentReverbSend = reverbSend;
+    currentSpeed = speedRatio;
+    slipMode = slipEnabled;
+    syncing = syncEnabled;
+    eqGainDb[Low]  = lowGainDb;
+    eqGainDb[Mid]  = midGainDb;
+    eqGainDb[High] = highGainDb;
 
-    transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    // The audio thread isn't running, so the current track can't change under us
+    if (trackSource != nullptr)
+        trackSource->prepareToPlay(samplesPerBlockExpected, sourceSampleRate);
+
+    resampleSource.setResamplingRatio(maxResamplingRatio);
     resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    resampleSource.setResamplingRatio(1.0);
+    appliedRatio = 0.0;
+    updateResamplingRatio();
 
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = (juce::uint32) samplesPerBlockExpected;
     spec.numChannels = 1;
 
+    updateEQCoefficients();
     eqLeft.prepare(spec);
     eqRight.prepare(spec);
     eqLeft.reset();
     eqRight.reset();
 
-    updateEQCoefficients();
+    effects.setAmount(DeckEffects::filterSlot, filterAmount);
+    effects.setAmount(DeckEffects::flangerSlot, flangerAmount);
+    effects.setAmount(DeckEffects::echoSlot, echoAmount);
+    effects.prepare(sampleRate, samplesPerBlockExpected);
+
+    meter.prepare(sampleRate);
+    spectrum.prepare(sampleRate);
+    publishBeatClock();
 }
 
 void DJAudioPlayer::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
 {
-    resampleSource.getNextAudioBlock(bufferToFill);
-
     auto* buffer = bufferToFill.buffer;
     if (!buffer) return;
 
-    auto block = juce::dsp::AudioBlock<float>(*buffer)
-                    .getSubBlock((size_t)bufferToFill.startSample,
-                                 (size_t)bufferToFill.numSamples);
+    if (pendingTrack.load(std::memory_order_relaxed) != nullptr || deferredRetire != nullptr)
+        adoptPendingTrack();
 
-    if (buffer->getNumChannels() >= 1)
-    {
-        auto leftBlock = block.getSingleChannelBlock(0);
-        juce::dsp::ProcessContextReplacing<float> ctx(leftBlock);
-        eqLeft.process(ctx);
-    }
+    const int64 blockStart = sampleClock;
+    const int64 blockEnd = blockStart + bufferToFill.numSamples;
+    int done = 0;
 
-    if (buffer->getNumChannels() >= 2)
+    // Split the block at every command that lands inside it, so each one
+    // takes effect on its exact sample
+    while (done < bufferToFill.numSamples)
     {
-        auto rightBlock = block.getSingleChannelBlock(1);
-        juce::dsp::ProcessContextReplacing<float> ctx(rightBlock);
-        eqRight.process(ctx);
+        const int64 now = blockStart + done;
+        int64 segmentEnd = blockEnd;
+
+        // Drain both queues into 'scheduled', due or not, so everything due
+        // now can be applied in the order it was pushed
+        bool leftInQueue = false;
+
+        for (auto* queue : { &commandQueue, &controllerQueue })
+        {
+            DeckCommand command;
+            while (queue->peek(command))
+            {
+                dropSupersededCommands(command, now);
+
+                if (numScheduled == (int) scheduled.size())
+                {
+                    leftInQueue = true;
+                    segmentEnd = jmin(segmentEnd, jmax(now + 1, command.targetSample));
+                    break;
+                }
+
+                // Keep 'scheduled' sorted by push order; the two queues
+                // interleave, so a command may go in before the last ones
+                int pos = numScheduled++;
+                for (; pos > 0 && command.isBefore(scheduled[(size_t) pos - 1]); --pos)
+                    scheduled[(size_t) pos] = scheduled[(size_t) pos - 1];
+                scheduled[(size_t) pos] = command;
+
+                queue->pop();
+            }
+        }
+
+        int kept = 0;
+        for (int i = 0; i < numScheduled; ++i)
+        {
+            const auto pending = scheduled[(size_t) i];
+
+            if (pending.targetSample <= now)
+            {
+                applyCommand(pending);
+            }
+            else
+            {
+                segmentEnd = jmin(segmentEnd, pending.targetSample);
+                scheduled[(size_t) kept++] = pending;
+            }
+        }
+        numScheduled = kept;
+
+        // 'scheduled' was full: applying what was due has made room, so take
+        // the rest of the queues before rendering anything
+        if (leftInQueue && numScheduled < (int) scheduled.size())
+            continue;
+
+        const int end = (int) (segmentEnd - blockStart);
+        renderSegment(*buffer, bufferToFill.startSample + done, end - done);
+        done = end;
     }
+
+    meter.measure(*buffer, bufferToFill.startSample, bufferToFill.numSamples);
+    spectrum.push(*buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+    sampleClock = blockStart + bufferToFill.numSamples;
+    publishedClock.store(sampleClock);
+    publishBeatClock();
 }
 
 void DJAudioPlayer::releaseResources()
 {
-    transportSource.releaseResources();
     resampleSource.releaseResources();
+
+    if (trackSource != nullptr)
+        trackSource->releaseResources();
 }
 
-void DJAudioPlayer::loadURL(URL audioURL)
+void DJAudioPlayer::loadURL(URL audioURL, bool waitUntilLoaded)
 {
-    auto stream = audioURL.createInputStream(false);
-    if (stream == nullptr)
+    logControl(ControlLog::EventType::load, 0.0, audioURL.toString(false));
+
+    const int generation = ++loadGeneration;
+
+    // Cues belong to a track; the caller sets the new track's cues after this
     {
-        bpm = 0.0;
-        return;
+        const ScopedLock sl(trackInfoLock);
+        hotCuePositions.fill(-1.0);
     }
 
-    auto* reader = formatManager.createReaderFor(std::move(stream));
-    if (reader == nullptr)
+    if (waitUntilLoaded)
     {
-        bpm = 0.0;
+        loaderPool.removeAllJobs(true, 10000);
+        publishTrack(prepareTrack(audioURL), audioURL, generation);
         return;
     }
 
+    loaderPool.addJob([this, audioURL, generation]
+    {
+        // Skip loads that were superseded before they started
+        if (generation != loadGeneration.load())
+            return;
+
+        publishTrack(prepareTrack(audioURL), audioURL, generation);
+    });
+}
+
+void DJAudioPlayer::queueURL(URL audioURL)
+{
+    const int generation = ++queueGeneration;
+    std::unique_ptr<LoadedTrack> previous;
+
+    {
+        const ScopedLock sl(trackInfoLock);
+        queuedURL = audioURL;
+        previous = std::move(queuedTrack);
+    }
+
+    loaderPool.addJob([this, audioURL, generation, previousTrack = previous.release()]
+    {
+        delete previousTrack;
+
+        if (generation != queueGeneration.load())
+            return;
+
+        auto track = prepareTrack(audioURL);
+        std::unique_ptr<LoadedTrack> unused;
+
+        const ScopedLock sl(trackInfoLock);
+
+        // Queued again, or already swapped in, while this was being prepared
+        if (generation != queueGeneration.load())
+        {
+            unused = std::move(track);
+            return;
+        }
+
+        if (track == nullptr)
+            queuedURL = URL();
+
+        queuedTrack = std::move(track);
+    });
+}
+
+bool DJAudioPlayer::loadQueued()
+{
+    std::unique_ptr<LoadedTrack> unused;
+    RetiredTracks replaced;
+    URL audioURL;
+
+    {
+        const ScopedLock sl(trackInfoLock);
+        if (queuedTrack == nullptr) return false;
+
+        audioURL = queuedURL;
+        logControl(ControlLog::EventType::load, 0.0, audioURL.toString(false));
+
+        // Supersede any load or queue still in flight
+        ++loadGeneration;
+        ++queueGeneration;
+
+        queuedURL = URL();
+        hotCuePositions.fill(-1.0);
+        handOverTrack(std::move(queuedTrack), audioURL, unused, replaced);
+    }
+
+    // Leave the clean-up to the loader thread
+    loaderPool.addJob([this, unusedTrack = unused.release(), replacedTracks = new RetiredTracks(std::move(replaced))]
+    {
+        delete unusedTrack;
+        delete replacedTracks;
+    });
+
+    return true;
+}
+
+URL DJAudioPlayer::getQueuedURL() const
+{
+    const ScopedLock sl(trackInfoLock);
+    return queuedURL;
+}
+
+bool DJAudioPlayer::isQueuedTrackReady() const
+{
+    const ScopedLock sl(trackInfoLock);
+    return queuedTrack != nullptr;
+}
+
+std::unique_ptr<DJAudioPlayer::LoadedTrack> DJAudioPlayer::prepareTrack(const URL& audioURL)
+{
+    auto stream = audioURL.createInputStream(false);
+    if (stream == nullptr)
+        return nullptr;
+
+    auto* reader = formatManager.createReaderFor(std::move(stream));
+    if (reader == nullptr)
+        return nullptr;
+
+    auto track = std::make_unique<LoadedTrack>();
+
     // -------- BPM ANALYSIS --------
     const double sr = reader->sampleRate;
     const int numCh = (int) reader->numChannels;
@@ -104,96 +337,1268 @@ void DJAudioPlayer::loadURL(URL audioURL)
 
         reader->read(&analysisBuffer, 0, maxSamplesToRead, 0, true, true);
 
-        bpm = BPMDetector::detectBpmFromBuffer(
+        track->bpm = BPMDetector::detectBpmFromBuffer(
             analysisBuffer, sr, 70.0, 200.0);
+
+        if (track->bpm > 0.0)
+            track->firstBeatSec = BPMDetector::detectFirstBeatSec(analysisBuffer, sr, track->bpm);
     }
-    else
+
+    track->sampleRate = sr;
+    track->lengthSec = sr > 0.0 ? (double) reader->lengthInSamples / sr : 0.0;
+
+    // -------- NORMAL LOADING --------
+    // Decoding happens on the read-ahead thread; the audio thread only
+    // copies out of the buffer
+    const int bufferSize = jmax(32768, (int) (sr * readAheadSeconds));
+    track->source.reset(new BufferingAudioSource(new AudioFormatReaderSource(reader, true),
+                                                 readAheadThread.getObject(), true, bufferSize, 2));
+    track->source->prepareToPlay(preparedBlockSize, sr);
+
+    // Let the read-ahead get going, so the first blocks never play silence
+    const int primeSamples = jmin(bufferSize / 2, (int) (sr * primeSeconds));
+    track->source->waitForNextAudioBlockReady(AudioSourceChannelInfo(nullptr, 0, primeSamples), 2000);
+
+    // The cue cache decodes from a reader of its own
+    std::unique_ptr<AudioFormatReader> cueReader;
+    if (auto cueStream = audioURL.createInputStream(false))
+        cueReader.reset(formatManager.createReaderFor(std::move(cueStream)));
+
+    track->cueCache = std::make_shared<HotCueCache>(readAheadThread.getObject());
+    track->cueCache->setTrack(std::move(cueReader));
+
+    track->loopAudio.setSize(2, crossfadeSamples + (int) (sr * maxLoopSeconds));
+    track->scratch = std::make_unique<ScratchPlayer>(sr);
+
+    return track;
+}
+
+void DJAudioPlayer::publishTrack(std::unique_ptr<LoadedTrack> track, const URL& audioURL, int generation)
+{
+    // Anything freed here goes after the lock is released
+    std::unique_ptr<LoadedTrack> unused;
+    RetiredTracks replaced;
+
+    const ScopedLock sl(trackInfoLock);
+
+    // A newer load was asked for while this one was running
+    if (generation != loadGeneration.load())
+    {
+        unused = std::move(track);
+        return;
+    }
+
+    if (track == nullptr)
     {
         bpm = 0.0;
+        return;
     }
 
-    // -------- NORMAL LOADING --------
-    std::unique_ptr<AudioFormatReaderSource> newSource(
-        new AudioFormatReaderSource(reader, true)
-    );
+    handOverTrack(std::move(track), audioURL, unused, replaced);
+}
+
+void DJAudioPlayer::handOverTrack(std::unique_ptr<LoadedTrack> track, const URL& audioURL,
+                                  std::unique_ptr<LoadedTrack>& unused, RetiredTracks& replaced)
+{
+    // Take back a track the audio thread never picked up, and the ones it
+    // has swapped out, so the hand-over slots are empty again
+    unused.reset(pendingTrack.exchange(nullptr));
+    takeRetiredTracks(replaced);
+
+    loadedURL = audioURL;
+    bpm = track->bpm;
+    trackLengthSec = track->lengthSec;
+    loadedSampleRate = track->sampleRate;
+    loadedCueCache = track->cueCache;
+
+    // Start caching any cues that were set while the track was loading
+    for (int slot = 0; slot < HotCueCache::numSlots; ++slot)
+        if (hotCuePositions[(size_t) slot] >= 0.0)
+            loadedCueCache->setCue(slot, (int64) (hotCuePositions[(size_t) slot] * trackLengthSec * loadedSampleRate));
+
+    pendingTrack.store(track.release());
+}
+
+void DJAudioPlayer::takeRetiredTracks(RetiredTracks& into)
+{
+    for (size_t i = 0; i < retiredTracks.size(); ++i)
+        if (auto* track = retiredTracks[i].exchange(nullptr))
+        {
+            jassert(into[i] == nullptr);
+            into[i].reset(track);
+        }
+}
+
+bool DJAudioPlayer::retireTrack(std::unique_ptr<LoadedTrack>& track)
+{
+    for (auto& slot : retiredTracks)
+    {
+        LoadedTrack* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, track.get()))
+        {
+            track.release();
+            return true;
+        }
+    }
 
-    transportSource.setSource(newSource.get(),
-                              0,
-                              nullptr,
-                              reader->sampleRate);
+    return false;
+}
+
+void DJAudioPlayer::adoptPendingTrack()
+{
+    // Until the last track swapped out has somewhere to go, nothing else is
+    // swapped in; the loader empties the slots on every hand-over
+    if (deferredRetire != nullptr && ! retireTrack(deferredRetire))
+        return;
+
+    std::unique_ptr<LoadedTrack> next(pendingTrack.exchange(nullptr));
+    if (next == nullptr) return;
+
+    // Nothing may be playing out of the old cache or loop buffer after this
+    releaseCue();
+    crossfadeLength = 0;
+    loopActive = false;
+
+    // Swap buffers rather than copying, so nothing is allocated or freed
+    // here; the old loop buffer leaves with the old track
+    std::swap(loopAudio, next->loopAudio);
+    std::swap(currentTrack, next);
+
+    if (next != nullptr)
+        std::swap(next->loopAudio, currentTrack->loopAudio);
 
-    readerSource.reset(newSource.release());
+    trackSource = currentTrack->source.get();
+    cueCache = currentTrack->cueCache.get();
+    scratchPlayer = currentTrack->scratch.get();
+    scratchFadeLength = 0;
+    sourceSampleRate = currentTrack->sampleRate;
+    trackBpm = currentTrack->bpm;
+    trackFirstBeatSec = currentTrack->firstBeatSec;
+    playing = false;
+    fadeOutPending = false;
+    appliedRatio = 0.0;
+    resampleSource.flushBuffers();
+
+    // Never overwrites a slot, so a hand-over racing this can't lose a track
+    if (next != nullptr && ! retireTrack(next))
+        deferredRetire = std::move(next);
+}
+
+URL DJAudioPlayer::getLoadedURL() const
+{
+    const ScopedLock sl(trackInfoLock);
+    return loadedURL;
+}
+
+double DJAudioPlayer::getBpm() const
+{
+    const ScopedLock sl(trackInfoLock);
+    return bpm;
 }
 
 void DJAudioPlayer::setGain(double gain)
 {
     gain = juce::jlimit(0.0, 1.0, gain);
-    transportSource.setGain(gain);
+    scheduleCommand(makeCommand(DeckCommand::Type::setGain, gain));
 }
 
 void DJAudioPlayer::setSpeed(double ratio)
 {
     ratio = juce::jlimit(0.1, 4.0, ratio);
-    resampleSource.setResamplingRatio(ratio);
+    scheduleCommand(makeCommand(DeckCommand::Type::setSpeed, ratio));
 }
 
 void DJAudioPlayer::setPosition(double posInSecs)
 {
-    transportSource.setPosition(posInSecs);
+    scheduleCommand(makeCommand(DeckCommand::Type::setPosition, posInSecs));
 }
 
 void DJAudioPlayer::setPositionRelative(double pos)
+{
+    setPositionRelativeAt(pos, 0);
+}
+
+void DJAudioPlayer::setPositionRelativeAt(double pos, int64 targetSample)
 {
     pos = juce::jlimit(0.0, 1.0, pos);
-    double length = transportSource.getLengthInSeconds();
-    if (length > 0.0)
-        setPosition(length * pos);
+
+    double lengthSec = 0.0;
+    {
+        const ScopedLock sl(trackInfoLock);
+        lengthSec = trackLengthSec;
+    }
+
+    if (lengthSec > 0.0)
+        scheduleCommand(makeCommand(DeckCommand::Type::setPosition, lengthSec * pos, targetSample));
+}
+
+void DJAudioPlayer::setHotCue(int slot, double pos)
+{
+    if (! isPositiveAndBelow(slot, HotCueCache::numSlots)) return;
+
+    const ScopedLock sl(trackInfoLock);
+
+    hotCuePositions[(size_t) slot] = pos >= 0.0 ? juce::jlimit(0.0, 1.0, pos) : -1.0;
+
+    // While a load is running this caches the old track; the new one
+    // picks the cue up when it is published
+    const double secs = hotCuePositions[(size_t) slot] * trackLengthSec;
+    if (loadedCueCache != nullptr)
+        loadedCueCache->setCue(slot, pos >= 0.0 ? (int64) (secs * loadedSampleRate) : -1);
+}
+
+void DJAudioPlayer::jumpToHotCue(int slot, int64 targetSample)
+{
+    const double secs = getHotCueSeconds(slot);
+    if (secs < 0.0) return;
+
+    auto command = makeCommand(DeckCommand::Type::jumpToCue, secs, targetSample);
+    command.index = slot;
+    scheduleCommand(command);
+}
+
+double DJAudioPlayer::getHotCueSeconds(int slot) const
+{
+    if (! isPositiveAndBelow(slot, HotCueCache::numSlots)) return -1.0;
+
+    const ScopedLock sl(trackInfoLock);
+    if (hotCuePositions[(size_t) slot] < 0.0) return -1.0;
+
+    return hotCuePositions[(size_t) slot] * trackLengthSec;
+}
+
+void DJAudioPlayer::setLoopIn()
+{
+    scheduleCommand(makeCommand(DeckCommand::Type::loopIn, 0.0));
+}
+
+void DJAudioPlayer::setLoopOut()
+{
+    scheduleCommand(makeCommand(DeckCommand::Type::loopOut, 0.0));
+}
+
+void DJAudioPlayer::startBeatLoop(double beats, int64 targetSample)
+{
+    if (beats > 0.0)
+        scheduleCommand(makeCommand(DeckCommand::Type::beatLoop, beats, targetSample));
+}
+
+void DJAudioPlayer::halveLoop()
+{
+    scheduleCommand(makeCommand(DeckCommand::Type::loopHalve, 0.0));
+}
+
+void DJAudioPlayer::doubleLoop()
+{
+    scheduleCommand(makeCommand(DeckCommand::Type::loopDouble, 0.0));
+}
+
+void DJAudioPlayer::exitLoop()
+{
+    scheduleCommand(makeCommand(DeckCommand::Type::loopExit, 0.0));
+}
+
+void DJAudioPlayer::setSlipMode(bool shouldSlip)
+{
+    scheduleCommand(makeCommand(DeckCommand::Type::setSlip, shouldSlip ? 1.0 : 0.0));
+}
+
+void DJAudioPlayer::setScratchTouch(bool isTouching)
+{
+    scheduleCommand(makeCommand(DeckCommand::Type::scratch, isTouching ? 1.0 : 0.0));
+}
+
+void DJAudioPlayer::setScratchRate(double rate)
+{
+    rate = juce::jlimit(-8.0, 8.0, rate);
+    scheduleCommand(makeCommand(DeckCommand::Type::scratchRate, rate));
 }
 
-void DJAudioPlayer::start()  { transportSource.start(); }
-void DJAudioPlayer::stop()   { transportSource.stop(); }
+void DJAudioPlayer::setSync(bool shouldSync)
+{
+    scheduleCommand(makeCommand(DeckCommand::Type::setSync, shouldSync ? 1.0 : 0.0));
+}
+
+void DJAudioPlayer::start()
+{
+    startAt(0);
+}
+
+void DJAudioPlayer::startAt(int64 targetSample)
+{
+    scheduleCommand(makeCommand(DeckCommand::Type::start, 0.0, targetSample));
+}
+
+void DJAudioPlayer::stop()
+{
+    scheduleCommand(makeCommand(DeckCommand::Type::stop, 0.0));
+}
+
+bool DJAudioPlayer::scheduleCommand(const DeckCommand& command, bool fromController)
+{
+    using Type = DeckCommand::Type;
+
+    // If nothing is draining the queue (no audio device), these control
+    // values are still picked up by the next prepareToPlay()
+    switch (command.type)
+    {
+        case Type::setGain:         gainValue = command.value; break;
+        case Type::setSpeed:        speedRatio = command.value; break;
+        case Type::setLowEQ:        lowGainDb = (float) command.value; break;
+        case Type::setMidEQ:        midGainDb = (float) command.value; break;
+        case Type::setHighEQ:       highGainDb = (float) command.value; break;
+        case Type::setFilter:       filterAmount = (float) command.value; break;
+        case Type::setFlanger:      flangerAmount = (float) command.value; break;
+        case Type::setEcho:         echoAmount = (float) command.value; break;
+        case Type::setReverbSend:   reverbSend = (float) command.value; break;
+        case Type::setSlip:         slipEnabled = command.value > 0.5; break;
+        case Type::setSync:         syncEnabled = command.value > 0.5; break;
+        case Type::scratch:         scratchTouched = command.value > 0.5; break;
+        default:                    break;
+    }
+
+    auto stamped = command;
+    stamped.sequence = nextSequence.fetch_add(1);
+
+    const bool queued = fromController ? controllerQueue.push(stamped)
+                                       : commandQueue.push(stamped);
+    if (! queued)
+    {
+        droppedCommands.fetch_add(1);
+        return false;
+    }
+
+    // Only commands the deck will actually apply go into the log, so a
+    // replay never hears a change the live mix didn't
+    logCommand(command);
+    return true;
+}
+
+void DJAudioPlayer::logCommand(const DeckCommand& command)
+{
+    using Type = DeckCommand::Type;
+    using Event = ControlLog::EventType;
+    const auto t = command.targetSample;
+
+    switch (command.type)
+    {
+        case Type::start:           logControl(Event::play, 0.0, {}, t); break;
+        case Type::stop:            logControl(Event::stop, 0.0, {}, t); break;
+        case Type::setPosition:
+        case Type::jumpToCue:       logControl(Event::seek, command.value, {}, t); break;
+        case Type::setGain:         logControl(Event::gain, command.value, {}, t); break;
+        case Type::setSpeed:        logControl(Event::speed, command.value, {}, t); break;
+        case Type::setLowEQ:        logControl(Event::lowEQ, command.value, {}, t); break;
+        case Type::setMidEQ:        logControl(Event::midEQ, command.value, {}, t); break;
+        case Type::setHighEQ:       logControl(Event::highEQ, command.value, {}, t); break;
+        case Type::setFilter:       logControl(Event::filter, command.value, {}, t); break;
+        case Type::setFlanger:      logControl(Event::flanger, command.value, {}, t); break;
+        case Type::setEcho:         logControl(Event::echo, command.value, {}, t); break;
+        case Type::setReverbSend:   logControl(Event::reverbSend, command.value, {}, t); break;
+        case Type::loopIn:          logControl(Event::loopIn, 0.0, {}, t); break;
+        case Type::loopOut:         logControl(Event::loopOut, 0.0, {}, t); break;
+        case Type::beatLoop:        logControl(Event::beatLoop, command.value, {}, t); break;
+        case Type::loopHalve:       logControl(Event::loopHalve, 0.0, {}, t); break;
+        case Type::loopDouble:      logControl(Event::loopDouble, 0.0, {}, t); break;
+        case Type::loopExit:        logControl(Event::loopExit, 0.0, {}, t); break;
+        case Type::setSlip:         logControl(Event::slip, command.value, {}, t); break;
+        case Type::setSync:         logControl(Event::sync, command.value, {}, t); break;
+        case Type::scratch:         logControl(Event::scratch, command.value, {}, t); break;
+        case Type::scratchRate:     logControl(Event::scratchRate, command.value, {}, t); break;
+    }
+}
+
+void DJAudioPlayer::dropSupersededCommands(const DeckCommand& command, int64 now)
+{
+    using Type = DeckCommand::Type;
+
+    // A stop or start replaces any start or stop still waiting for its beat,
+    // and a seek any seek still waiting; a quantised start followed by a
+    // stop must not start the deck on the beat anyway
+    auto group = [](Type type)
+    {
+        switch (type)
+        {
+            case Type::start:
+            case Type::stop:        return 1;
+            case Type::setPosition:
+            case Type::jumpToCue:   return 2;
+            default:                return 0;
+        }
+    };
+
+    const int commandGroup = group(command.type);
+    if (commandGroup == 0) return;
+
+    int kept = 0;
+    for (int i = 0; i < numScheduled; ++i)
+    {
+        const auto& pending = scheduled[(size_t) i];
+
+        if (pending.targetSample > now && group(pending.type) == commandGroup && pending.isBefore(command))
+            continue;
+
+        scheduled[(size_t) kept++] = pending;
+    }
+    numScheduled = kept;
+}
 
 double DJAudioPlayer::getPositionRelative()
 {
-    double len = transportSource.getLengthInSeconds();
-    if (len <= 0.0) return 0.0;
-    return transportSource.getCurrentPosition() / len;
+    const auto clock = beatClock.read();
+    if (clock.lengthSec <= 0.0) return 0.0;
+    return clock.positionSec / clock.lengthSec;
 }
 
 void DJAudioPlayer::setLowEQGainDb(float gainDb)
 {
-    lowGainDb = juce::jlimit(-24.0f, 24.0f, gainDb);
-    updateEQCoefficients();
+    gainDb = juce::jlimit(-24.0f, 24.0f, gainDb);
+    scheduleCommand(makeCommand(DeckCommand::Type::setLowEQ, gainDb));
 }
 
 void DJAudioPlayer::setMidEQGainDb(float gainDb)
 {
-    midGainDb = juce::jlimit(-24.0f, 24.0f, gainDb);
-    updateEQCoefficients();
+    gainDb = juce::jlimit(-24.0f, 24.0f, gainDb);
+    scheduleCommand(makeCommand(DeckCommand::Type::setMidEQ, gainDb));
 }
 
 void DJAudioPlayer::setHighEQGainDb(float gainDb)
 {
-    highGainDb = juce::jlimit(-24.0f, 24.0f, gainDb);
-    updateEQCoefficients();
+    gainDb = juce::jlimit(-24.0f, 24.0f, gainDb);
+    scheduleCommand(makeCommand(DeckCommand::Type::setHighEQ, gainDb));
 }
 
-void DJAudioPlayer::updateEQCoefficients()
+void DJAudioPlayer::setFilterAmount(float amount)
 {
-    if (currentSampleRate <= 0.0) return;
+    amount = juce::jlimit(-1.0f, 1.0f, amount);
+    scheduleCommand(makeCommand(DeckCommand::Type::setFilter, amount));
+}
+
+void DJAudioPlayer::setFlangerAmount(float amount)
+{
+    amount = juce::jlimit(0.0f, 1.0f, amount);
+    scheduleCommand(makeCommand(DeckCommand::Type::setFlanger, amount));
+}
+
+void DJAudioPlayer::setEchoAmount(float amount)
+{
+    amount = juce::jlimit(0.0f, 1.0f, amount);
+    scheduleCommand(makeCommand(DeckCommand::Type::setEcho, amount));
+}
+
+void DJAudioPlayer::setReverbSend(float level)
+{
+    level = juce::jlimit(0.0f, 1.0f, level);
+    scheduleCommand(makeCommand(DeckCommand::Type::setReverbSend, level));
+}
+
+void DJAudioPlayer::setControlLog(ControlLog* log, int deckIndex)
+{
+    controlLog = log;
+    controlLogDeck = deckIndex;
+}
+
+int64 DJAudioPlayer::getNextBeatSample(int64 earliestSample) const
+{
+    const auto clock = beatClock.read();
+
+    if (! clock.playing || clock.bpm <= 0.0 || clock.tempoRatio <= 0.0)
+        return -1;
+
+    const double beatSec = 60.0 / clock.bpm;
+    const double secondsPerSample = clock.tempoRatio / clock.outputSampleRate;
+
+    // Track position at the earliest allowed sample, then round up to the grid
+    const double earliestPos = clock.positionSec
+                             + (double) (earliestSample - clock.clockSample) * secondsPerSample;
+    const double beatIndex = std::ceil((earliestPos - clock.firstBeatSec) / beatSec);
+    const double beatPos = clock.firstBeatSec + beatIndex * beatSec;
+
+    return clock.clockSample
+         + (int64) std::ceil((beatPos - clock.positionSec) / secondsPerSample);
+}
+
+void DJAudioPlayer::logControl(ControlLog::EventType type, double value,
+                               const String& path, int64 targetSample)
+{
+    if (auto* log = controlLog.load())
+        log->record(controlLogDeck, type, value, path, targetSample);
+}
+
+void DJAudioPlayer::applyCommand(const DeckCommand& command)
+{
+    switch (command.type)
+    {
+        case DeckCommand::Type::start:
+            playing = trackSource != nullptr;
+            fadeOutPending = false;
+            break;
+
+        case DeckCommand::Type::stop:
+            fadeOutPending = playing;
+            playing = false;
+            break;
+
+        case DeckCommand::Type::setPosition:
+            stopScratching();
+
+            if (trackSource != nullptr && sourceSampleRate > 0.0)
+            {
+                releaseCue();
+                crossfadeLength = 0;
+                loopActive = false;
+                trackSource->setNextReadPosition((int64) (jmax(0.0, command.value) * sourceSampleRate));
+                resampleSource.flushBuffers();
+            }
+            break;
+
+        case DeckCommand::Type::jumpToCue:
+            stopScratching();
+            jumpToCachedCue(command.index, command.value);
+            break;
+
+        case DeckCommand::Type::loopIn:
+            stopScratching();
+            beginLoop(0);
+            break;
+
+        case DeckCommand::Type::loopOut:
+            if (loopActive && ! loopClosed && loopPos > 0)
+            {
+                // The fade-out reads on past the loop-out point, which is
+                // still captured, so the wrap has audio to fade from
+                const int length = loopPos;
+                captureCrossfadeTail();
+                closeLoop(length);
+                loopPos = 0;
+            }
+            break;
+
+        case DeckCommand::Type::beatLoop:
+            stopScratching();
+
+            if (sourceSampleRate > 0.0)
+            {
+                const double beatSec = 60.0 / (trackBpm > 0.0 ? trackBpm : 120.0);
+                const int length = jmax(1, roundToInt(command.value * beatSec * sourceSampleRate));
+
+                // A new size while looping keeps the loop-in point
+                if (loopActive && loopClosed) resizeLoop(length);
+                else                          beginLoop(length);
+            }
+            break;
+
+        case DeckCommand::Type::loopHalve:
+            resizeLoop(loopLength / 2);
+            break;
+
+        case DeckCommand::Type::loopDouble:
+            resizeLoop(loopLength * 2);
+            break;
+
+        case DeckCommand::Type::loopExit:
+            leaveLoop();
+            break;
+
+        case DeckCommand::Type::setSlip:
+            slipMode = command.value > 0.5;
+
+            // Without slip the reader has to sit at the end of the captured loop
+            if (! slipMode && loopActive && trackSource != nullptr
+                && getLinearPosition() != loopStart + loopCaptured)
+            {
+                releaseCue();
+                trackSource->setNextReadPosition(loopStart + loopCaptured);
+            }
+            break;
+
+        case DeckCommand::Type::setSync:
+            syncing = command.value > 0.5;
+            if (! syncing) syncSpeed = 0.0;
+            updateResamplingRatio();
+            break;
+
+        case DeckCommand::Type::setGain:
+            currentGain = (float) command.value;
+            break;
+
+        case DeckCommand::Type::setSpeed:
+            currentSpeed = command.value;
+            updateResamplingRatio();
+            break;
+
+        case DeckCommand::Type::setLowEQ:
+            eqGainDb[Low] = (float) command.value;
+            updateEQCoefficients();
+            break;
+
+        case DeckCommand::Type::setMidEQ:
+            eqGainDb[Mid] = (float) command.value;
+            updateEQCoefficients();
+            break;
+
+        case DeckCommand::Type::setHighEQ:
+            eqGainDb[High] = (float) command.value;
+            updateEQCoefficients();
+            break;
+
+        case DeckCommand::Type::setFilter:
+            effects.setAmount(DeckEffects::filterSlot, (float) command.value);
+            break;
+
+        case DeckCommand::Type::setFlanger:
+            effects.setAmount(DeckEffects::flangerSlot, (float) command.value);
+            break;
+
+        case DeckCommand::Type::setEcho:
+            effects.setAmount(DeckEffects::echoSlot, (float) command.value);
+            break;
+
+        case DeckCommand::Type::setReverbSend:
+            currentReverbSend = (float) command.value;
+            break;
+
+        case DeckCommand::Type::scratch:
+            if (command.value > 0.5)    startScratch();
+            else if (scratchPlayer != nullptr) scratchPlayer->release();
+            break;
+
+        case DeckCommand::Type::scratchRate:
+            if (scratchPlayer != nullptr && scratchPlayer->isTouched())
+                scratchPlayer->setTargetRate(command.value);
+            break;
+    }
+}
+
+void DJAudioPlayer::renderSegment(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (numSamples <= 0) return;
+
+    if (scratchPlayer != nullptr && scratchPlayer->isActive())
+    {
+        renderScratch(buffer, startSample, numSamples);
+    }
+    else
+    {
+        updateResamplingRatio();
+        resampleSource.getNextAudioBlock(AudioSourceChannelInfo(&buffer, startSample, numSamples));
+        applyScratchFade(buffer, startSample, numSamples);
+    }
+
+    auto block = juce::dsp::AudioBlock<float>(buffer)
+                    .getSubBlock((size_t)startSample,
+                                 (size_t)numSamples);
+
+    if (buffer.getNumChannels() >= 1)
+    {
+        auto leftBlock = block.getSingleChannelBlock(0);
+        juce::dsp::ProcessContextReplacing<float> ctx(leftBlock);
+        eqLeft.process(ctx);
+    }
+
+    if (buffer.getNumChannels() >= 2)
+    {
+        auto rightBlock = block.getSingleChannelBlock(1);
+        juce::dsp::ProcessContextReplacing<float> ctx(rightBlock);
+        eqRight.process(ctx);
+    }
+
+    // The flanger and echo follow the tempo the deck is actually playing at
+    effects.setTempo(trackBpm > 0.0 ? trackBpm * getEffectiveSpeed() : 120.0);
+    effects.process(buffer, startSample, numSamples);
+}
+
+void DJAudioPlayer::readTrack(const AudioSourceChannelInfo& info)
+{
+    if (trackSource == nullptr || ! (playing || fadeOutPending))
+    {
+        info.clearActiveBufferRegion();
+        return;
+    }
+
+    readFromTrack(info);
+
+    // Fade the old position out over the start of a hot cue
+    if (crossfadePos < crossfadeLength)
+    {
+        const int count = jmin(crossfadeLength - crossfadePos, info.numSamples);
+        const float gainStart = (float) crossfadePos / (float) crossfadeLength;
+        const float gainEnd = (float) (crossfadePos + count) / (float) crossfadeLength;
+
+        info.buffer->applyGainRamp(info.startSample, count, gainStart, gainEnd);
+
+        for (int ch = 0; ch < info.buffer->getNumChannels(); ++ch)
+            info.buffer->addFromWithRamp(ch, info.startSample,
+                                         crossfadeTail.getReadPointer(jmin(ch, crossfadeTail.getNumChannels() - 1), crossfadePos),
+                                         count, 1.0f - gainStart, 1.0f - gainEnd);
+
+        crossfadePos += count;
+    }
+
+    if (fadeOutPending)
+    {
+        const int fadeLength = jmin(stopFadeSamples, info.numSamples);
+        info.buffer->applyGainRamp(info.startSample, fadeLength, 1.0f, 0.0f);
+
+        if (info.numSamples > fadeLength)
+            for (int ch = 0; ch < info.buffer->getNumChannels(); ++ch)
+                info.buffer->clear(ch, info.startSample + fadeLength, info.numSamples - fadeLength);
+
+        fadeOutPending = false;
+        return;
+    }
+
+    if (getTrackPosition() >= trackSource->getTotalLength())
+        playing = false;
+}
+
+void DJAudioPlayer::readFromTrack(const AudioSourceChannelInfo& info)
+{
+    if (loopActive)
+    {
+        // Records the scratch window piece by piece, as the loop may wrap
+        readLoop(info);
+    }
+    else
+    {
+        readLinear(info);
+
+        if (scratchPlayer != nullptr)
+            scratchPlayer->pushHistory(*info.buffer, info.startSample, info.numSamples, getLinearPosition());
+    }
+
+    pushHistory(info);
+}
+
+void DJAudioPlayer::readLinear(const AudioSourceChannelInfo& info)
+{
+    int done = 0;
+
+    while (done < info.numSamples)
+    {
+        if (cueAudio != nullptr)
+        {
+            const int count = jmin(info.numSamples - done, cueLength - cueReadPos);
+
+            for (int ch = 0; ch < info.buffer->getNumChannels(); ++ch)
+                info.buffer->copyFrom(ch, info.startSample + done, *cueAudio,
+                                      jmin(ch, cueAudio->getNumChannels() - 1), cueReadPos, count);
+
+            cueReadPos += count;
+            done += count;
+
+            // The main reader has been waiting at the end of the cached audio
+            if (cueReadPos >= cueLength)
+                releaseCue();
+
+            continue;
+        }
+
+        const AudioSourceChannelInfo rest(info.buffer, info.startSample + done, info.numSamples - done);
+
+        if (nonRealtime)
+            trackSource->waitForNextAudioBlockReady(rest, 5000);
+
+        trackSource->getNextAudioBlock(rest);
+        done = info.numSamples;
+    }
+}
+
+bool DJAudioPlayer::waitForReadAhead(int numSamples, int timeoutMs)
+{
+    if (trackSource == nullptr || ! playing) return true;
+
+    // The resampler reads a few samples past what the speed alone needs
+    const double ratio = appliedRatio > 0.0 ? appliedRatio : getEffectiveSpeed();
+    const int64 left = trackSource->getTotalLength() - trackSource->getNextReadPosition();
+    const int needed = (int) jmin(left, (int64) std::ceil(numSamples * ratio) + 8);
+
+    return needed <= 0
+        || trackSource->waitForNextAudioBlockReady(AudioSourceChannelInfo(nullptr, 0, needed), timeoutMs);
+}
+
+void DJAudioPlayer::jumpToCachedCue(int slot, double fallbackSecs)
+{
+    if (trackSource == nullptr || sourceSampleRate <= 0.0) return;
+
+    // Keep hold of a few milliseconds of the old position to fade out
+    captureCrossfadeTail();
+    loopActive = false;
+    releaseCue();
+
+    int64 start = 0;
+    int length = 0;
+
+    if (auto* audio = cueCache != nullptr ? cueCache->acquire(slot, start, length) : nullptr)
+    {
+        cueAudio = audio;
+        cueSlot = slot;
+        cueStart = start;
+        cueLength = length;
+        cueReadPos = 0;
+
+        // The read-ahead refills from the end of the cached audio while it plays
+        trackSource->setNextReadPosition(start + length);
+    }
+    else
+    {
+        // Not cached yet: fall back to a plain seek
+        crossfadeLength = 0;
+        trackSource->setNextReadPosition((int64) (jmax(0.0, fallbackSecs) * sourceSampleRate));
+        resampleSource.flushBuffers();
+    }
+}
+
+void DJAudioPlayer::releaseCue()
+{
+    if (cueAudio == nullptr) return;
+
+    if (cueCache != nullptr)
+        cueCache->release(cueSlot);
+    cueAudio = nullptr;
+    cueSlot = -1;
+}
+
+void DJAudioPlayer::captureCrossfadeTail()
+{
+    crossfadeLength = 0;
+    if (! playing) return;
+
+    readFromTrack(AudioSourceChannelInfo(&crossfadeTail, 0, crossfadeSamples));
+    crossfadeLength = crossfadeSamples;
+    crossfadePos = 0;
+}
+
+//==============================================================================
+// Loops and rolls
+
+void DJAudioPlayer::readLoop(const AudioSourceChannelInfo& info)
+{
+    const int capacity = loopAudio.getNumSamples() - crossfadeSamples;
+    int done = 0;
+
+    while (done < info.numSamples)
+    {
+        // Out of room before a loop-out: loop what has been captured so far
+        if (! loopClosed && loopPos >= capacity)
+            closeLoop(loopPos);
+
+        if (loopClosed && loopPos >= loopLength)
+            loopPos = 0;
+
+        const int end = loopClosed ? loopLength : capacity;
+        const int dest = info.startSample + done;
+        int count = jmin(info.numSamples - done, end - loopPos);
+
+        if (loopPos < loopCaptured)
+        {
+            count = jmin(count, loopCaptured - loopPos);
+
+            for (int ch = 0; ch < info.buffer->getNumChannels(); ++ch)
+                info.buffer->copyFrom(ch, dest, loopAudio, jmin(ch, loopAudio.getNumChannels() - 1),
+                                      crossfadeSamples + loopPos, count);
+
+            if (slipMode)
+                advanceShadow(count);
+        }
+        else
+        {
+            // First time through: play from the track and keep a copy. The
+            // reader is always parked at the end of the captured audio here.
+            readLinear(AudioSourceChannelInfo(info.buffer, dest, count));
+
+            for (int ch = 0; ch < loopAudio.getNumChannels(); ++ch)
+                loopAudio.copyFrom(ch, crossfadeSamples + loopPos, *info.buffer,
+                                   jmin(ch, info.buffer->getNumChannels() - 1), dest, count);
+
+            loopCaptured = loopPos + count;
+        }
+
+        if (loopClosed)
+            applyLoopCrossfade(*info.buffer, dest, loopPos, count);
+
+        if (scratchPlayer != nullptr)
+            scratchPlayer->pushHistory(*info.buffer, dest, count, loopStart + loopPos + count);
+
+        loopPos += count;
+        done += count;
+    }
+}
+
+void DJAudioPlayer::applyLoopCrossfade(AudioBuffer<float>& buffer, int startSample,
+                                       int loopPosition, int numSamples)
+{
+    // Over the last loopFade samples, fade the loop out and the pre-roll in,
+    // so the audio arrives at the loop-in point continuously
+    const int fadeStart = loopLength - loopFade;
+    const int from = jmax(loopPosition, fadeStart);
+    const int to = jmin(loopPosition + numSamples, loopLength);
+
+    if (loopFade <= 0 || from >= to) return;
+
+    const float gainStart = (float) (from - fadeStart) / (float) loopFade;
+    const float gainEnd = (float) (to - fadeStart) / (float) loopFade;
+    const int dest = startSample + (from - loopPosition);
+    const int preRoll = crossfadeSamples - loopFade + (from - fadeStart);
+
+    buffer.applyGainRamp(dest, to - from, 1.0f - gainStart, 1.0f - gainEnd);
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        buffer.addFromWithRamp(ch, dest,
+                               loopAudio.getReadPointer(jmin(ch, loopAudio.getNumChannels() - 1), preRoll),
+                               to - from, gainStart, gainEnd);
+}
+
+void DJAudioPlayer::advanceShadow(int numSamples)
+{
+    // The shadow playhead is the reader itself, kept moving in real time
+    while (numSamples > 0)
+    {
+        const int count = jmin(numSamples, shadowScratch.getNumSamples());
+        readLinear(AudioSourceChannelInfo(&shadowScratch, 0, count));
+        numSamples -= count;
+    }
+}
+
+void DJAudioPlayer::pushHistory(const AudioSourceChannelInfo& info)
+{
+    const int size = historyRing.getNumSamples();
+    const int count = jmin(info.numSamples, size);
+    const int source = info.startSample + info.numSamples - count;
+    const int first = jmin(count, size - historyWritePos);
+
+    for (int ch = 0; ch < historyRing.getNumChannels(); ++ch)
+    {
+        const int sourceCh = jmin(ch, info.buffer->getNumChannels() - 1);
+
+        historyRing.copyFrom(ch, historyWritePos, *info.buffer, sourceCh, source, first);
+        if (count > first)
+            historyRing.copyFrom(ch, 0, *info.buffer, sourceCh, source + first, count - first);
+    }
+
+    historyWritePos = (historyWritePos + count) % size;
+}
+
+void DJAudioPlayer::beginLoop(int lengthInSamples)
+{
+    if (trackSource == nullptr || loopAudio.getNumSamples() <= crossfadeSamples)
+        return;
+
+    leaveLoop();
+
+    // The tail of an old loop is about to be overwritten: go back to the reader
+    if (cueAudio == &loopAudio)
+    {
+        const auto position = getLinearPosition();
+        releaseCue();
+        trackSource->setNextReadPosition(position);
+    }
+
+    // The pre-roll is whatever played just before the loop-in point
+    const int tail = crossfadeSamples - historyWritePos;
+
+    for (int ch = 0; ch < loopAudio.getNumChannels(); ++ch)
+    {
+        loopAudio.copyFrom(ch, 0, historyRing, ch, historyWritePos, tail);
+        loopAudio.copyFrom(ch, tail, historyRing, ch, 0, historyWritePos);
+    }
+
+    loopStart = getLinearPosition();
+    loopPos = 0;
+    loopCaptured = 0;
+    loopLength = 0;
+    loopClosed = false;
+    loopActive = true;
+
+    if (lengthInSamples > 0)
+        closeLoop(lengthInSamples);
+}
+
+void DJAudioPlayer::closeLoop(int lengthInSamples)
+{
+    loopLength = jlimit(1, loopAudio.getNumSamples() - crossfadeSamples, lengthInSamples);
+    loopFade = jmin(crossfadeSamples, loopLength / 2);
+    loopClosed = true;
+}
+
+void DJAudioPlayer::resizeLoop(int lengthInSamples)
+{
+    if (! loopActive || ! loopClosed) return;
+
+    lengthInSamples = jlimit(1, loopAudio.getNumSamples() - crossfadeSamples, lengthInSamples);
+
+    // Growing the loop captures more of the track, which needs the reader
+    // at the end of the captured audio; in slip mode it has moved on
+    if (lengthInSamples > loopCaptured && getLinearPosition() != loopStart + loopCaptured)
+        return;
+
+    if (loopPos >= lengthInSamples)
+    {
+        captureCrossfadeTail();
+        loopPos %= lengthInSamples;
+    }
+
+    closeLoop(lengthInSamples);
+}
+
+void DJAudioPlayer::leaveLoop()
+{
+    if (! loopActive) return;
+
+    if (slipMode)
+    {
+        // The shadow playhead carries on from where the track would have been
+        captureCrossfadeTail();
+        loopActive = false;
+        return;
+    }
+
+    loopActive = false;
+
+    // Carry on from the current point in the loop: play out the rest of the
+    // captured audio, then the reader, which is parked at the end of it
+    if (loopPos >= loopCaptured) return;
+
+    const int64 position = loopStart + loopPos;
+
+    if (cueAudio != nullptr && position >= cueStart)
+    {
+        // The loop was captured from a hot cue that is still playing from the cache
+        cueReadPos = (int) (position - cueStart);
+        return;
+    }
+
+    releaseCue();
+    cueAudio = &loopAudio;
+    cueSlot = -1;
+    cueStart = loopStart - crossfadeSamples;
+    cueReadPos = crossfadeSamples + loopPos;
+    cueLength = crossfadeSamples + loopCaptured;
+}
+
+//==============================================================================
+// Scratching
+
+void DJAudioPlayer::startScratch()
+{
+    if (scratchPlayer == nullptr || trackSource == nullptr) return;
+
+    if (scratchPlayer->isActive())
+    {
+        scratchPlayer->touch();
+        return;
+    }
+
+    const int64 playhead = getTrackPosition();
+
+    // The platter takes over from loops and cues
+    releaseCue();
+    crossfadeLength = 0;
+    loopActive = false;
+    scratchFadeLength = 0;
+
+    scratchPlayer->begin(playhead, playing ? getEffectiveSpeed() : 0.0);
+    scratchShadow = (double) playhead;
+
+    // The reader tops the window up from its end from now on
+    if (trackSource->getNextReadPosition() != scratchPlayer->getEnd())
+        trackSource->setNextReadPosition(scratchPlayer->getEnd());
+}
+
+void DJAudioPlayer::renderScratch(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // The motor keeps turning under the hand. A stopped deck's platter spins
+    // down by itself, so there is no stop fade.
+    const double motor = playing ? getEffectiveSpeed() : 0.0;
+    scratchPlayer->setMotorRate(motor);
+    fadeOutPending = false;
+    scratchShadow += motor * numSamples * sourceSampleRate / currentSampleRate;
+
+    if (! scratchPlayer->hasSettled())
+        fillScratchWindow();
+
+    scratchPlayer->render(buffer, startSample, numSamples, currentSampleRate);
+
+    if (! scratchPlayer->hasSettled()) return;
+
+    // Back at the deck's speed: play out the window into the reader, or in
+    // slip mode jump to where the track would have been
+    if (slipMode && motor > 0.0)
+        finishScratch((int64) scratchShadow);
+    else if (motor <= 0.0 || scratchPlayer->getSamplesAhead() <= ScratchPlayer::maxHandoverSamples)
+        finishScratch(-1);
+}
+
+void DJAudioPlayer::fillScratchWindow()
+{
+    const int64 total = trackSource->getTotalLength();
+    int wanted = scratchPlayer->getSamplesWanted();
+
+    while (wanted > 0)
+    {
+        const int64 available = total - scratchPlayer->getEnd();
+        const auto region = scratchPlayer->getFillRegion(available > 0 ? (int) jmin((int64) wanted, available)
+                                                                        : wanted);
+        if (available <= 0)
+        {
+            // Past the end of the track
+            region.clearActiveBufferRegion();
+        }
+        else
+        {
+            // Only take what the read-ahead has decoded; a slow disk leaves
+            // the window short rather than full of silence
+            if (! trackSource->waitForNextAudioBlockReady(region, nonRealtime ? 5000 : 0))
+                break;
+
+            trackSource->getNextAudioBlock(region);
+        }
+
+        scratchPlayer->commitFill(region.numSamples);
+        wanted -= region.numSamples;
+    }
+}
+
+void DJAudioPlayer::finishScratch(int64 seekPosition)
+{
+    if (seekPosition < 0)
+    {
+        // Play out the rest of the window, then the reader parked at its end
+        int64 start = 0;
+        int length = 0;
+
+        if (auto* rest = scratchPlayer->copyRemaining(start, length))
+        {
+            cueAudio = rest;
+            cueSlot = -1;
+            cueStart = start;
+            cueLength = length;
+            cueReadPos = 0;
+        }
+        else
+        {
+            seekPosition = jmax((int64) 0, (int64) scratchPlayer->getPosition());
+        }
+    }
+
+    if (seekPosition >= 0)
+        trackSource->setNextReadPosition(seekPosition);
+
+    // Keep a few milliseconds of the platter to fade out over the normal path
+    scratchPlayer->render(scratchFade, 0, crossfadeSamples, currentSampleRate);
+    scratchFadeLength = crossfadeSamples;
+    scratchFadePos = 0;
+
+    scratchPlayer->end();
+    resampleSource.flushBuffers();
+    appliedRatio = 0.0;
+}
+
+void DJAudioPlayer::stopScratching()
+{
+    if (scratchPlayer != nullptr && scratchPlayer->isActive())
+        finishScratch((int64) scratchPlayer->getPosition());
+}
+
+void DJAudioPlayer::applyScratchFade(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (scratchFadePos >= scratchFadeLength) return;
+
+    const int count = jmin(scratchFadeLength - scratchFadePos, numSamples);
+    const float gainStart = (float) scratchFadePos / (float) scratchFadeLength;
+    const float gainEnd = (float) (scratchFadePos + count) / (float) scratchFadeLength;
+
+    buffer.applyGainRamp(startSample, count, gainStart, gainEnd);
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        buffer.addFromWithRamp(ch, startSample,
+                               scratchFade.getReadPointer(jmin(ch, scratchFade.getNumChannels() - 1), scratchFadePos),
+                               count, 1.0f - gainStart, 1.0f - gainEnd);
+
+    scratchFadePos += count;
+}
+
+int64 DJAudioPlayer::getTrackPosition() const
+{
+    if (scratchPlayer != nullptr && scratchPlayer->isActive())
+        return (int64) scratchPlayer->getPosition();
+
+    if (loopActive)
+        return loopStart + loopPos;
+
+    return getLinearPosition();
+}
+
+int64 DJAudioPlayer::getLinearPosition() const
+{
+    if (cueAudio != nullptr)
+        return cueStart + cueReadPos;
+
+    return trackSource != nullptr ? trackSource->getNextReadPosition() : 0;
+}
+
+double DJAudioPlayer::getEffectiveSpeed() const
+{
+    return syncing && syncSpeed > 0.0 ? syncSpeed : currentSpeed;
+}
+
+void DJAudioPlayer::updateResamplingRatio()
+{
+    double ratio = getEffectiveSpeed();
+    if (sourceSampleRate > 0.0 && currentSampleRate > 0.0)
+        ratio *= sourceSampleRate / currentSampleRate;
+
+    if (ratio != appliedRatio)
+    {
+        resampleSource.setResamplingRatio(ratio);
+        appliedRatio = ratio;
+    }
+}
+
+void DJAudioPlayer::publishBeatClock()
+{
+    BeatClock clock;
+    clock.clockSample = sampleClock;
+    clock.tempoRatio = getEffectiveSpeed();
+    clock.bpm = trackBpm;
+    clock.firstBeatSec = trackFirstBeatSec;
+    clock.outputSampleRate = currentSampleRate;
+    clock.playing = playing;
+
+    if (trackSource != nullptr && sourceSampleRate > 0.0)
+    {
+        clock.positionSec = (double) getTrackPosition() / sourceSampleRate;
+        clock.lengthSec = (double) trackSource->getTotalLength() / sourceSampleRate;
+
+        if (loopActive && loopClosed)
+            clock.loopLengthSec = (double) loopLength / sourceSampleRate;
+    }
+
+    clock.looping = loopActive;
+    clock.publishedMs = Time::getMillisecondCounterHiRes();
+
+    beatClock.publish(clock);
+}
+
+void DJAudioPlayer::updateEQCoefficients()
+{
+    if (currentSampleRate <= 0.0) return;
+
+    // ArrayCoefficients only fill in std::arrays, so this is safe on the audio thread
+    using ArrayCoeffs = juce::dsp::IIR::ArrayCoefficients<float>;
 
-    auto low  = Coeffs::makeLowShelf (currentSampleRate, lowFreqHz,  midQ,
-                                      juce::Decibels::decibelsToGain(lowGainDb));
-    auto mid  = Coeffs::makePeakFilter(currentSampleRate, midFreqHz, midQ,
-                                      juce::Decibels::decibelsToGain(midGainDb));
-    auto high = Coeffs::makeHighShelf(currentSampleRate, highFreqHz, midQ,
-                                      juce::Decibels::decibelsToGain(highGainDb));
+    const auto low  = ArrayCoeffs::makeLowShelf (currentSampleRate, lowFreqHz,  midQ,
+                                                 juce::Decibels::decibelsToGain(eqGainDb[Low]));
+    const auto mid  = ArrayCoeffs::makePeakFilter(currentSampleRate, midFreqHz, midQ,
+                                                 juce::Decibels::decibelsToGain(eqGainDb[Mid]));
+    const auto high = ArrayCoeffs::makeHighShelf(currentSampleRate, highFreqHz, midQ,
+                                                 juce::Decibels::decibelsToGain(eqGainDb[High]));
 
-    *eqLeft.get<Low>().coefficients  = *low;
-    *eqLeft.get<Mid>().coefficients  = *mid;
-    *eqLeft.get<High>().coefficients = *high;
+    *eqLeft.get<Low>().coefficients  = low;
+    *eqLeft.get<Mid>().coefficients  = mid;
+    *eqLeft.get<High>().coefficients = high;
 
-    *eqRight.get<Low>().coefficients  = *low;
-    *eqRight.get<Mid>().coefficients  = *mid;
-    *eqRight.get<High>().coefficients = *high;
+    *eqRight.get<Low>().coefficients  = low;
+    *eqRight.get<Mid>().coefficients  = mid;
+    *eqRight.get<High>().coefficients = high;
 }
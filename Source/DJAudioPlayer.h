@@ -10,7 +10,18 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include <array>
+#include <atomic>
+#include <memory>
 #include "BPMDetector.h"
+#include "ControlLog.h"
+#include "DeckEffects.h"
+#include "DeckCommandQueue.h"
+#include "HotCueCache.h"
+#include "LevelMeterSource.h"
+#include "ScratchPlayer.h"
+#include "SeqLockSnapshot.h"
+#include "SpectrumSource.h"
 
 class DJAudioPlayer : public AudioSource
 {
@@ -20,14 +31,31 @@ public:
 
     /** Prepare audio pipeline for playback */
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
-    /** Fill the audio buffer with the next block of samples, applying EQ */
+    /** Fill the audio buffer with the next block of samples, applying queued
+        commands on their target samples and then the EQ and FX. The volume
+        is left to the mixer, which taps the deck before it for the cue bus. */
     void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill) override;
     /** Release audio resources when no longer needed */
     void releaseResources() override;
 
-    /** Load an audio file from a URL into the player */
-    void loadURL(URL audioURL);
-    /** Set the playback volume (0.0 to 1.0) */
+    /** Load an audio file from a URL into the player. The file is opened,
+        analysed and buffered on a background thread and handed to the audio
+        thread once it is ready, so this returns straight away unless
+        waitUntilLoaded is true (offline rendering needs the track in place
+        before the next block). A newer load supersedes one still running. */
+    void loadURL(URL audioURL, bool waitUntilLoaded = false);
+    /** Prepare a track in the background without touching what is playing,
+        ready for loadQueued(). Replaces any track already queued. */
+    void queueURL(URL audioURL);
+    /** Swap the queued track in. This only exchanges pointers, so the deck
+        is ready to play straight away. Returns false if no queued track has
+        finished preparing. */
+    bool loadQueued();
+    /** Get the URL of the queued track (empty if nothing is queued) */
+    URL getQueuedURL() const;
+    /** Check whether the queued track has finished preparing */
+    bool isQueuedTrackReady() const;
+    /** Set the channel volume (0.0 to 1.0), applied by the mixer */
     void setGain(double gain);
     /** Set the playback speed ratio (0.1 to 4.0, where 1.0 is normal) */
     void setSpeed(double ratio);
@@ -41,12 +69,77 @@ public:
     /** Stop audio playback */
     void stop();
 
+    /** Start playback exactly at the given sample on the mixer clock */
+    void startAt(int64 targetSample);
+    /** Jump to a fraction of the track exactly at the given sample on the mixer clock */
+    void setPositionRelativeAt(double pos, int64 targetSample);
+    /** Set a hot cue as a fraction of the track (negative clears it) and
+        start caching the audio after it */
+    void setHotCue(int slot, double pos);
+    /** Jump to a hot cue at the given sample on the mixer clock (0 = now),
+        playing from its cached audio with a short crossfade */
+    void jumpToHotCue(int slot, int64 targetSample = 0);
+    /** Return a hot cue's position in seconds, or -1 if it isn't set */
+    double getHotCueSeconds(int slot) const;
+
+    /** Mark the loop-in point here and start capturing the loop */
+    void setLoopIn();
+    /** Close the loop here and jump back to the loop-in point */
+    void setLoopOut();
+    /** Loop the given number of beats starting now, or at targetSample */
+    void startBeatLoop(double beats, int64 targetSample = 0);
+    /** Halve the length of the active loop */
+    void halveLoop();
+    /** Double the length of the active loop */
+    void doubleLoop();
+    /** Leave the active loop */
+    void exitLoop();
+    /** In slip mode the track keeps moving underneath loops and rolls, and
+        leaving one picks up where the track would have been */
+    void setSlipMode(bool shouldSlip);
+    /** Get the slip mode last passed to setSlipMode() */
+    bool getSlipMode() const { return slipEnabled; }
+
+    /** Put a hand on the platter (true) or take it off (false). While the
+        hand is on, the deck plays at the rate given to setScratchRate();
+        once it is off the platter spins back up to the deck's speed. */
+    void setScratchTouch(bool isTouching);
+    /** Set the speed the hand moves the platter at: 1 = normal, 0 = held
+        still, negative = backwards (-8 to 8) */
+    void setScratchRate(double rate);
+    /** Check whether a hand was last put on the platter */
+    bool isScratchTouched() const { return scratchTouched; }
+
+    /** Follow another deck's tempo and beat phase (see DJMixer) */
+    void setSync(bool shouldSync);
+    /** Get the sync state last passed to setSync() */
+    bool getSync() const { return syncEnabled; }
+
+    /** Queue a command for the audio thread. Every control change goes
+        through here; targetSample 0 means "as soon as possible".
+        The message thread and a hardware controller each have a queue of
+        their own, so a controller never waits behind the GUI. Only one
+        thread at a time may send commands with fromController set.
+        Returns false if the queue was full; the command is then dropped,
+        counted, and left out of the control log. */
+    bool scheduleCommand(const DeckCommand& command, bool fromController = false);
+    /** Return how many commands have been dropped because a queue was full */
+    int getNumDroppedCommands() const { return droppedCommands.load(); }
+
     /** Get the current playback position as a fraction (0.0 to 1.0) */
     double getPositionRelative();
+    /** Get the current playback position in seconds */
+    double getPositionSeconds() const { return beatClock.read().positionSec; }
+    /** Get the URL of the loaded track (empty if nothing is loaded) */
+    URL getLoadedURL() const;
+    /** Get the playback volume last passed to setGain() */
+    double getGain() const { return gainValue; }
+    /** Get the playback speed ratio last passed to setSpeed() */
+    double getSpeed() const { return speedRatio; }
     /** Get the detected BPM of the loaded track (0.0 if unknown) */
-    double getBpm() const { return bpm; }
+    double getBpm() const;
     /** Check whether audio is currently playing */
-    bool isPlaying() const { return transportSource.isPlaying(); }
+    bool isPlaying() const { return beatClock.read().playing; }
 
     /** Set the low-band EQ gain in dB (-24 to +24) */
     void setLowEQGainDb (float gainDb);
@@ -55,12 +148,176 @@ public:
     /** Set the high-band EQ gain in dB (-24 to +24) */
     void setHighEQGainDb(float gainDb);
 
+    float getLowEQGainDb() const  { return lowGainDb; }
+    float getMidEQGainDb() const  { return midGainDb; }
+    float getHighEQGainDb() const { return highGainDb; }
+
+    /** Set the filter knob: below 0 sweeps a low-pass, above 0 a high-pass (-1 to 1) */
+    void setFilterAmount (float amount);
+    /** Set the flanger depth (0 = off, 1 = full) */
+    void setFlangerAmount(float amount);
+    /** Set the beat-synced echo send and feedback (0 = off, 1 = full) */
+    void setEchoAmount   (float amount);
+
+    float getFilterAmount() const  { return filterAmount; }
+    float getFlangerAmount() const { return flangerAmount; }
+    float getEchoAmount() const    { return echoAmount; }
+
+    /** Set how much of the deck's output feeds the mixer's reverb (0 to 1) */
+    void setReverbSend(float level);
+    float getReverbSend() const { return reverbSend; }
+    /** Return the send level the audio thread is using (audio thread) */
+    float getAppliedReverbSend() const { return currentReverbSend; }
+    /** Return the volume the audio thread is using (audio thread) */
+    float getAppliedGain() const { return currentGain; }
+
+    /** Record every control change made on this player into a log (nullptr to stop) */
+    void setControlLog(ControlLog* log, int deckIndex);
+
+    /** Where the deck's playhead is on the mixer clock, published by the
+        audio thread once per block */
+    struct BeatClock
+    {
+        int64 clockSample = 0;          // mixer sample the other fields refer to
+        double positionSec = 0.0;       // track position at clockSample
+        double tempoRatio = 1.0;        // track seconds per output second
+        double lengthSec = 0.0;
+        double bpm = 0.0;
+        double firstBeatSec = 0.0;
+        double outputSampleRate = 44100.0;
+        double loopLengthSec = 0.0;     // 0 while no loop is closed
+        double publishedMs = 0.0;       // Time::getMillisecondCounterHiRes() when published
+        bool playing = false;
+        bool looping = false;
+
+        /** Estimate the track position at a moment on the hi-res millisecond
+            counter, assuming the deck carried on at the same rate since the
+            snapshot. Never runs more than 100 ms past it, in case the audio
+            has stopped. */
+        double getPositionAt(double timeMs) const
+        {
+            if (! playing)
+                return positionSec;
+
+            const double elapsedSec = jlimit(0.0, 100.0, timeMs - publishedMs) * 0.001;
+            return jlimit(0.0, jmax(0.0, lengthSec), positionSec + elapsedSec * tempoRatio);
+        }
+    };
+
+    /** Read the latest playhead snapshot (any thread, lock-free) */
+    BeatClock getBeatClock() const { return beatClock.read(); }
+    /** Return the deck's level meter (post EQ and FX, before the volume, as
+        on a mixer's channel meters) */
+    const LevelMeterSource& getMeter() const { return meter; }
+    /** Return the deck's spectrum analyser, fed from the same point as the meter */
+    SpectrumSource& getSpectrum() { return spectrum; }
+    /** Return the mixer sample of the first beat on this deck's grid at or
+        after earliestSample, or -1 if the deck is stopped or has no tempo */
+    int64 getNextBeatSample(int64 earliestSample) const;
+
+    /** When rendering offline, wait for the read-ahead instead of playing
+        silence if the disk falls behind */
+    void setNonRealtime(bool shouldBeNonRealtime) { nonRealtime = shouldBeNonRealtime; }
+    /** Wait until the read-ahead holds the track audio the next block of
+        numSamples will play. Returns false if it still doesn't after
+        timeoutMs (audio thread only, between blocks). */
+    bool waitForReadAhead(int numSamples, int timeoutMs);
+
+    /** Return the next sample this deck will render on the mixer clock */
+    int64 getSampleClock() const { return publishedClock.load(); }
+    /** Keep the deck's clock in step with the mixer (audio thread only) */
+    void setSampleClock(int64 sample) { sampleClock = sample; }
+
+    /** Check whether sync is switched on for this deck (audio thread only) */
+    bool isSyncActive() const { return syncing; }
+    /** Play at this speed instead of the speed control while synced, or
+        go back to the speed control if ratio is 0 (audio thread only) */
+    void setSyncSpeed(double ratio) { syncSpeed = ratio; }
+
 private:
     using Filter = juce::dsp::IIR::Filter<float>;
     using Coeffs = juce::dsp::IIR::Coefficients<float>;
     using Chain  = juce::dsp::ProcessorChain<Filter, Filter, Filter>;
 
+    /** Feeds the resampler from the loaded track (audio thread only) */
+    struct TrackFeed : public AudioSource
+    {
+        explicit TrackFeed(DJAudioPlayer& o) : owner(o) {}
+        void prepareToPlay(int, double) override {}
+        void releaseResources() override {}
+        void getNextAudioBlock(const AudioSourceChannelInfo& info) override { owner.readTrack(info); }
+
+        DJAudioPlayer& owner;
+    };
+
+    /** Everything that changes when a track is loaded. Built on the loader
+        thread, handed to the audio thread through pendingTrack, and handed
+        back through retiredTracks so it is destroyed off the audio thread,
+        by the next hand-over or the destructor. */
+    struct LoadedTrack
+    {
+        std::unique_ptr<BufferingAudioSource> source;
+        std::shared_ptr<HotCueCache> cueCache;
+        std::unique_ptr<ScratchPlayer> scratch;
+        AudioBuffer<float> loopAudio;
+        double sampleRate = 0.0;
+        double lengthSec = 0.0;
+        double bpm = 0.0;
+        double firstBeatSec = 0.0;
+    };
+
+    /** Background thread shared by every deck for read-ahead and cue caching */
+    struct ReadAheadThread : public TimeSliceThread
+    {
+        ReadAheadThread() : TimeSliceThread("Deck read-ahead") { startThread(Thread::Priority::high); }
+        ~ReadAheadThread() override { stopThread(2000); }
+    };
+
+    std::unique_ptr<LoadedTrack> prepareTrack(const URL& audioURL);
+    void publishTrack(std::unique_ptr<LoadedTrack> track, const URL& audioURL, int generation);
+    static constexpr int numRetireSlots = 2;
+    using RetiredTracks = std::array<std::unique_ptr<LoadedTrack>, numRetireSlots>;
+
+    void handOverTrack(std::unique_ptr<LoadedTrack> track, const URL& audioURL,
+                       std::unique_ptr<LoadedTrack>& unused, RetiredTracks& replaced);
+    void takeRetiredTracks(RetiredTracks& into);
+    void adoptPendingTrack();
+    bool retireTrack(std::unique_ptr<LoadedTrack>& track);
+
     void updateEQCoefficients();
+    void logControl(ControlLog::EventType type, double value,
+                    const String& path = {}, int64 targetSample = 0);
+    void logCommand(const DeckCommand& command);
+
+    void applyCommand(const DeckCommand& command);
+    /** Drop the pending commands a newly pushed one replaces (audio thread) */
+    void dropSupersededCommands(const DeckCommand& command, int64 now);
+    void renderSegment(AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void renderScratch(AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void fillScratchWindow();
+    void startScratch();
+    void finishScratch(int64 seekPosition);
+    void stopScratching();
+    void applyScratchFade(AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void readTrack(const AudioSourceChannelInfo& info);
+    void readFromTrack(const AudioSourceChannelInfo& info);
+    void readLinear(const AudioSourceChannelInfo& info);
+    void readLoop(const AudioSourceChannelInfo& info);
+    void applyLoopCrossfade(AudioBuffer<float>& buffer, int startSample, int loopPosition, int numSamples);
+    void advanceShadow(int numSamples);
+    void pushHistory(const AudioSourceChannelInfo& info);
+    void beginLoop(int lengthInSamples);
+    void closeLoop(int lengthInSamples);
+    void leaveLoop();
+    void resizeLoop(int lengthInSamples);
+    void captureCrossfadeTail();
+    void jumpToCachedCue(int slot, double fallbackSecs);
+    void releaseCue();
+    int64 getTrackPosition() const;
+    int64 getLinearPosition() const;
+    void updateResamplingRatio();
+    double getEffectiveSpeed() const;
+    void publishBeatClock();
 
     enum EqBand { Low = 0, Mid = 1, High = 2 };
 
@@ -68,19 +325,135 @@ private:
     Chain eqRight;
 
     double currentSampleRate = 44100.0;
-    double bpm = 0.0;
+    int preparedBlockSize = 512;
+
+    // Control values as last requested from the message thread or a
+    // controller; atomic because either may set them
+    std::atomic<double> gainValue { 1.0 };
+    std::atomic<double> speedRatio { 1.0 };
+    std::atomic<bool> slipEnabled { false };
+    std::atomic<bool> syncEnabled { false };
+    std::atomic<bool> scratchTouched { false };
 
     float lowFreqHz  = 200.0f;
     float midFreqHz  = 1000.0f;
     float highFreqHz = 6000.0f;
     float midQ = 0.707f;
 
-    float lowGainDb  = 0.0f;
-    float midGainDb  = 0.0f;
-    float highGainDb = 0.0f;
+    std::atomic<float> lowGainDb  { 0.0f };
+    std::atomic<float> midGainDb  { 0.0f };
+    std::atomic<float> highGainDb { 0.0f };
+
+    std::atomic<float> filterAmount  { 0.0f };
+    std::atomic<float> flangerAmount { 0.0f };
+    std::atomic<float> echoAmount    { 0.0f };
+    std::atomic<float> reverbSend    { 0.0f };
+
+    // Audio-thread state, only changed by applyCommand() or adoptPendingTrack()
+    float eqGainDb[3] = { 0.0f, 0.0f, 0.0f };
+    bool playing = false;
+    bool fadeOutPending = false;
+    float currentGain = 1.0f;
+    float currentReverbSend = 0.0f;
+    double currentSpeed = 1.0;
+    double appliedRatio = 0.0;
+    double sourceSampleRate = 0.0;
+    double trackBpm = 0.0;
+    double trackFirstBeatSec = 0.0;
+    int64 sampleClock = 0;
+    bool nonRealtime = false;
+    bool syncing = false;
+    double syncSpeed = 0.0;
+
+    // Hot cue being played out of the cache, and the tail of whatever was
+    // playing before the jump, faded out over the start of the cue
+    const AudioBuffer<float>* cueAudio = nullptr;
+    int cueSlot = -1;
+    int64 cueStart = 0;
+    int cueLength = 0;
+    int cueReadPos = 0;
+    AudioBuffer<float> crossfadeTail;
+    int crossfadeLength = 0;
+    int crossfadePos = 0;
+
+    // Loop or roll. The loop is captured into loopAudio the first time it
+    // plays, after a short pre-roll taken from historyRing that is faded in
+    // over the end of the loop, so the wrap point is seamless.
+    AudioBuffer<float> loopAudio;       // [pre-roll | loop], sized when a track loads
+    AudioBuffer<float> historyRing;     // the last few samples played
+    AudioBuffer<float> shadowScratch;   // slip mode reads the shadow playhead into here
+    int historyWritePos = 0;
+    bool loopActive = false;
+    bool loopClosed = false;            // false between loop-in and loop-out
+    bool slipMode = false;
+    int64 loopStart = 0;
+    int loopLength = 0;
+    int loopPos = 0;
+    int loopCaptured = 0;
+    int loopFade = 0;
+
+    // Scratching plays from the track's RAM window instead of the resampler.
+    // scratchShadow is where the track would be without the scratch, for
+    // slip mode, and scratchFade is the platter's output faded out over the
+    // first samples of the normal path afterwards.
+    ScratchPlayer* scratchPlayer = nullptr;
+    double scratchShadow = 0.0;
+    AudioBuffer<float> scratchFade;
+    int scratchFadeLength = 0;
+    int scratchFadePos = 0;
+
+    // Commands taken off the queues and not yet applied, in push order
+    std::array<DeckCommand, 32> scheduled;
+    int numScheduled = 0;
+    std::atomic<uint32> nextSequence { 0 };
+    std::atomic<int> droppedCommands { 0 };
+
+    std::atomic<int64> publishedClock { 0 };
+    SeqLockSnapshot<BeatClock> beatClock;
+    DeckEffects effects;
+    LevelMeterSource meter;
+    SpectrumSource spectrum;
+    DeckCommandQueue commandQueue;
+    DeckCommandQueue controllerQueue;
+
+    std::atomic<ControlLog*> controlLog { nullptr };
+    int controlLogDeck = 0;
 
     AudioFormatManager& formatManager;
-    std::unique_ptr<AudioFormatReaderSource> readerSource;
-    AudioTransportSource transportSource;
-    ResamplingAudioSource resampleSource{ &transportSource, false, 2 };
+
+    SharedResourcePointer<ReadAheadThread> readAheadThread;
+
+    // The most recently loaded track, as the message thread sees it. Written
+    // by whichever thread finishes a load; the audio thread never touches it.
+    CriticalSection trackInfoLock;
+    URL loadedURL;
+    double bpm = 0.0;
+    double trackLengthSec = 0.0;
+    double loadedSampleRate = 0.0;
+    std::array<double, HotCueCache::numSlots> hotCuePositions;   // fractions of the track, -1 = empty
+    std::shared_ptr<HotCueCache> loadedCueCache;
+    std::atomic<int> loadGeneration { 0 };
+
+    // The "next track" shadow slot, prepared on the loader thread
+    URL queuedURL;
+    std::unique_ptr<LoadedTrack> queuedTrack;
+    std::atomic<int> queueGeneration { 0 };
+
+    // The track the audio thread is playing, and the hand-over slots either side of it
+    std::unique_ptr<LoadedTrack> currentTrack;
+    BufferingAudioSource* trackSource = nullptr;
+    HotCueCache* cueCache = nullptr;
+    std::atomic<LoadedTrack*> pendingTrack { nullptr };
+    // Two slots: a hand-over can empty them while the audio thread is between
+    // taking the pending track and retiring the old one, which then lands in
+    // the free slot. If neither is free, the audio thread keeps the old track
+    // in deferredRetire and adopts nothing more until it has been retired.
+    std::array<std::atomic<LoadedTrack*>, numRetireSlots> retiredTracks {};
+    std::unique_ptr<LoadedTrack> deferredRetire;
+
+    TrackFeed trackFeed { *this };
+    ResamplingAudioSource resampleSource{ &trackFeed, false, 2 };
+
+    // Opens and analyses tracks; declared last so its job stops first
+    ThreadPool loaderPool { 1 };
 };
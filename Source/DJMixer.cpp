@@ -0,0 +1,392 @@
+/*
+  ==============================================================================
+
+    DJMixer.cpp
+    Created: 18 Oct 2026 10:20:13am
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "DJMixer.h"
+
+namespace
+{
+    /** A gain moving linearly across a block, as in AudioBuffer::addFromWithRamp() */
+    struct Ramp
+    {
+        Ramp(float from, float to, int numSamples)
+            : start(from), step((to - from) / (float) numSamples) {}
+
+        float at(int i) const { return start + step * (float) i; }
+
+        float start, step;
+    };
+
+    /** Add one channel of a deck into the master, and optionally the send
+        and cue buses, reading each sample once */
+    template <bool withSend, bool withCue>
+    void accumulate(const float* in, int numSamples,
+                    float* master, const Ramp& masterGain,
+                    float* send, const Ramp& sendGain,
+                    float* cue, const Ramp& cueGain)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = in[i];
+            master[i] += x * masterGain.at(i);
+
+            if constexpr (withSend) send[i] += x * sendGain.at(i);
+            if constexpr (withCue)  cue[i]  += x * cueGain.at(i);
+        }
+    }
+}
+
+DJMixer::DJMixer(AudioFormatManager& formatManagerToUse, int numDecks)
+    : formatManager(formatManagerToUse),
+      cueSwitches((size_t) jmax(1, numDecks))
+{
+    for (int i = 0; i < jmax(1, numDecks); ++i)
+        decks.add(new DJAudioPlayer(formatManager));
+
+    syncStates.resize((size_t) decks.size());
+    appliedSends.assign((size_t) decks.size(), 0.0f);
+    appliedGains.assign((size_t) decks.size(), 0.0f);
+    appliedCues.assign((size_t) decks.size(), 0.0f);
+}
+
+DJMixer::~DJMixer()
+{
+    stopRecording();
+}
+
+void DJMixer::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    currentBlockSize = samplesPerBlockExpected;
+
+    for (auto* deck : decks)
+        deck->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    deckBuffer.setSize(2, samplesPerBlockExpected);
+    sendBuffer.setSize(2, samplesPerBlockExpected);
+
+    for (int i = 0; i < decks.size(); ++i)
+    {
+        appliedSends[(size_t) i] = decks[i]->getReverbSend();
+        appliedGains[(size_t) i] = (float) decks[i]->getGain();
+        appliedCues[(size_t) i] = 0.0f;
+    }
+
+    appliedCueMix = 0.0f;
+
+    reverb.prepare(sampleRate, samplesPerBlockExpected);
+    masterBus.prepare(sampleRate, samplesPerBlockExpected);
+    masterSpectrum.prepare(sampleRate);
+}
+
+void DJMixer::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
+{
+    // Every deck schedules its commands against the mixer clock
+    const auto now = sampleClock.load();
+    for (auto* deck : decks)
+        deck->setSampleClock(now);
+
+    updateTempoSync(bufferToFill.numSamples);
+
+    auto& output = *bufferToFill.buffer;
+    const int start = bufferToFill.startSample;
+    const int numSamples = bufferToFill.numSamples;
+    const int numOutputs = jmin(2, output.getNumChannels());
+    const bool hasCueOutputs = output.getNumChannels() >= 4;
+    const float mix = cueMix.load();
+
+    // Hosts may ask for more than they promised
+    if (numSamples > deckBuffer.getNumSamples())
+    {
+        deckBuffer.setSize(2, numSamples, false, false, true);
+        sendBuffer.setSize(2, numSamples, false, false, true);
+    }
+
+    bufferToFill.clearActiveBufferRegion();
+    sendBuffer.clear(0, numSamples);
+
+    for (int i = 0; i < decks.size(); ++i)
+    {
+        // The deck comes out before its volume fader
+        decks[i]->getNextAudioBlock(AudioSourceChannelInfo(&deckBuffer, 0, numSamples));
+
+        // Every level is ramped from the one used for the last block. The
+        // send is post-fader; the cue is pre-fader.
+        auto& lastGain = appliedGains[(size_t) i];
+        auto& lastSend = appliedSends[(size_t) i];
+        auto& lastCue = appliedCues[(size_t) i];
+
+        const float gain = decks[i]->getAppliedGain();
+        const float send = decks[i]->getAppliedReverbSend() * gain;
+        const float cue = hasCueOutputs && cueSwitches[(size_t) i].load() ? 1.0f - mix : 0.0f;
+
+        const bool withSend = send > 0.0f || lastSend > 0.0f;
+        const bool withCue = cue > 0.0f || lastCue > 0.0f;
+
+        const Ramp masterRamp(lastGain, gain, numSamples);
+        const Ramp sendRamp(lastSend, send, numSamples);
+        const Ramp cueRamp(lastCue, cue, numSamples);
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            const float* in = deckBuffer.getReadPointer(ch);
+            float* master = ch < numOutputs ? output.getWritePointer(ch, start) : nullptr;
+            float* sendOut = sendBuffer.getWritePointer(ch);
+            float* cueOut = hasCueOutputs ? output.getWritePointer(2 + ch, start) : nullptr;
+
+            if (master == nullptr) continue;
+
+            if (withSend && withCue)  accumulate<true, true>  (in, numSamples, master, masterRamp, sendOut, sendRamp, cueOut, cueRamp);
+            else if (withSend)        accumulate<true, false> (in, numSamples, master, masterRamp, sendOut, sendRamp, cueOut, cueRamp);
+            else if (withCue)         accumulate<false, true> (in, numSamples, master, masterRamp, sendOut, sendRamp, cueOut, cueRamp);
+            else                      accumulate<false, false>(in, numSamples, master, masterRamp, sendOut, sendRamp, cueOut, cueRamp);
+        }
+
+        lastGain = gain;
+        lastSend = send;
+        lastCue = cue;
+    }
+
+    // The reverb keeps running with no send so its tail can ring out
+    reverb.process(sendBuffer, numSamples);
+
+    for (int ch = 0; ch < numOutputs; ++ch)
+        output.addFrom(ch, start, sendBuffer, ch, 0, numSamples);
+
+    masterBus.process(output, start, numSamples);
+    masterSpectrum.push(output, start, numSamples);
+
+    // The headphones blend the finished master in with the cue bus
+    if (hasCueOutputs)
+    {
+        if (mix > 0.0f || appliedCueMix > 0.0f)
+            for (int ch = 0; ch < 2; ++ch)
+                output.addFromWithRamp(2 + ch, start, output.getReadPointer(ch, start), numSamples,
+                                       appliedCueMix, mix);
+
+        appliedCueMix = mix;
+    }
+
+    sampleClock += bufferToFill.numSamples;
+}
+
+void DJMixer::setCueEnabled(int deckIndex, bool shouldCue)
+{
+    if (isPositiveAndBelow(deckIndex, decks.size()))
+        cueSwitches[(size_t) deckIndex].store(shouldCue);
+}
+
+bool DJMixer::isCueEnabled(int deckIndex) const
+{
+    return isPositiveAndBelow(deckIndex, decks.size()) && cueSwitches[(size_t) deckIndex].load();
+}
+
+void DJMixer::releaseResources()
+{
+    for (auto* deck : decks)
+        deck->releaseResources();
+}
+
+int DJMixer::findSyncMaster(int followerIndex) const
+{
+    auto usable = [this, followerIndex](int i)
+    {
+        if (i == followerIndex || ! isPositiveAndBelow(i, decks.size())) return false;
+
+        const auto clock = decks[i]->getBeatClock();
+        return clock.playing && clock.bpm > 0.0;
+    };
+
+    const int chosen = syncMaster.load();
+    if (usable(chosen))
+        return chosen;
+
+    // Prefer a deck that is playing at its own tempo over another follower
+    for (int i = 0; i < decks.size(); ++i)
+        if (usable(i) && ! decks[i]->isSyncActive())
+            return i;
+
+    for (int i = 0; i < decks.size(); ++i)
+        if (usable(i))
+            return i;
+
+    return -1;
+}
+
+void DJMixer::updateTempoSync(int numSamples)
+{
+    // Largest speed change the phase-lock loop may make on top of the tempo
+    // match, and how quickly it closes a phase error
+    constexpr double maxCorrection = 0.04;
+    constexpr double maxIntegral   = 0.02;
+    constexpr double pullInSeconds = 2.0;
+
+    const double blockSeconds = (double) numSamples / currentSampleRate;
+
+    for (int i = 0; i < decks.size(); ++i)
+    {
+        auto* follower = decks[i];
+        auto& state = syncStates[(size_t) i];
+
+        if (! follower->isSyncActive())
+        {
+            state.integral = 0.0;
+            continue;
+        }
+
+        const int masterIndex = findSyncMaster(i);
+        const auto f = follower->getBeatClock();
+
+        if (masterIndex < 0 || f.bpm <= 0.0)
+        {
+            follower->setSyncSpeed(0.0);
+            state.integral = 0.0;
+            continue;
+        }
+
+        const auto m = decks[masterIndex]->getBeatClock();
+        const double masterBpm = m.bpm * m.tempoRatio;
+
+        // Match tempo, treating half and double time as the same tempo
+        double followerBpm = f.bpm;
+        while (masterBpm / followerBpm > 1.5)  followerBpm *= 2.0;
+        while (masterBpm / followerBpm < 0.75) followerBpm *= 0.5;
+
+        const double tempoRatio = masterBpm / followerBpm;
+        double correction = 0.0;
+
+        if (m.playing && f.playing)
+        {
+            // Both snapshots are brought to the same mixer sample before comparing
+            const int64 now = sampleClock.load();
+            auto positionAt = [now](const DJAudioPlayer::BeatClock& c)
+            {
+                return c.positionSec + (double) (now - c.clockSample) * c.tempoRatio / c.outputSampleRate;
+            };
+
+            const double masterBeats = (positionAt(m) - m.firstBeatSec) * m.bpm / 60.0;
+            const double followerBeats = (positionAt(f) - f.firstBeatSec) * followerBpm / 60.0;
+
+            // Phase error in beats, wrapped to [-0.5, 0.5)
+            double error = masterBeats - followerBeats;
+            error -= std::floor(error + 0.5);
+
+            // A speed change of d gains d * t seconds of track time over t
+            // seconds, so closing 'error' beats in pullInSeconds needs this
+            const double beatSec = 60.0 / followerBpm;
+            const double proportional = error * beatSec / pullInSeconds;
+
+            state.integral = jlimit(-maxIntegral, maxIntegral,
+                                    state.integral + proportional * blockSeconds * 0.1);
+
+            correction = jlimit(-maxCorrection, maxCorrection, proportional + state.integral);
+        }
+
+        follower->setSyncSpeed(jlimit(0.1, 4.0, tempoRatio * (1.0 + correction)));
+    }
+}
+
+void DJMixer::setNonRealtime(bool shouldBeNonRealtime)
+{
+    for (auto* deck : decks)
+        deck->setNonRealtime(shouldBeNonRealtime);
+
+    reverb.setNonRealtime(shouldBeNonRealtime);
+}
+
+bool DJMixer::waitForReadAhead(int numSamples, int timeoutMs)
+{
+    bool ready = true;
+
+    for (auto* deck : decks)
+        ready = deck->waitForReadAhead(numSamples, timeoutMs) && ready;
+
+    return ready;
+}
+
+void DJMixer::loadReverbImpulse(const File& file, bool waitUntilLoaded)
+{
+    if (recordingLog != nullptr)
+        recordingLog->record(-1, ControlLog::EventType::impulse, 0.0, file.getFullPathName());
+
+    reverb.loadImpulseResponse(file, formatManager, waitUntilLoaded);
+}
+
+int64 DJMixer::getNextBeatSample(int deckIndex) const
+{
+    // Leave the message thread a couple of blocks to get the command queued
+    const int64 earliest = sampleClock.load() + 2 * currentBlockSize;
+
+    for (int i = 0; i < decks.size(); ++i)
+    {
+        if (i == deckIndex) continue;
+
+        const auto beat = decks[i]->getNextBeatSample(earliest);
+        if (beat >= 0)
+            return beat;
+    }
+
+    if (! isPositiveAndBelow(deckIndex, decks.size()))
+        return -1;
+
+    return decks[deckIndex]->getNextBeatSample(earliest);
+}
+
+void DJMixer::startRecording(ControlLog& log)
+{
+    stopRecording();
+
+    log.startRecording(sampleClock, currentSampleRate, decks.size());
+    recordingLog = &log;
+
+    const auto impulse = reverb.getImpulseResponseFile();
+    if (impulse != File())
+        log.record(-1, ControlLog::EventType::impulse, 0.0, impulse.getFullPathName());
+
+    for (int i = 0; i < decks.size(); ++i)
+    {
+        auto* deck = decks[i];
+        deck->setControlLog(&log, i);
+
+        // Snapshot the deck so the replay starts from the same state
+        const auto url = deck->getLoadedURL();
+        if (! url.isEmpty())
+            log.record(i, ControlLog::EventType::load, 0.0, url.toString(false));
+
+        log.record(i, ControlLog::EventType::gain, deck->getGain());
+        log.record(i, ControlLog::EventType::speed, deck->getSpeed());
+        log.record(i, ControlLog::EventType::lowEQ, deck->getLowEQGainDb());
+        log.record(i, ControlLog::EventType::midEQ, deck->getMidEQGainDb());
+        log.record(i, ControlLog::EventType::highEQ, deck->getHighEQGainDb());
+        log.record(i, ControlLog::EventType::filter, deck->getFilterAmount());
+        log.record(i, ControlLog::EventType::flanger, deck->getFlangerAmount());
+        log.record(i, ControlLog::EventType::echo, deck->getEchoAmount());
+        log.record(i, ControlLog::EventType::reverbSend, deck->getReverbSend());
+        log.record(i, ControlLog::EventType::slip, deck->getSlipMode() ? 1.0 : 0.0);
+        log.record(i, ControlLog::EventType::sync, deck->getSync() ? 1.0 : 0.0);
+
+        if (url.isEmpty()) continue;
+
+        log.record(i, ControlLog::EventType::seek, deck->getPositionSeconds());
+
+        if (deck->isPlaying())
+            log.record(i, ControlLog::EventType::play, 0.0);
+    }
+}
+
+void DJMixer::stopRecording()
+{
+    if (recordingLog == nullptr) return;
+
+    for (auto* deck : decks)
+        deck->setControlLog(nullptr, 0);
+
+    recordingLog->stopRecording();
+    recordingLog = nullptr;
+}
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    DJMixer.h
+    Created: 18 Oct 2026 10:20:13am
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+#include "DJAudioPlayer.h"
+#include "ControlLog.h"
+#include "ConvolutionReverb.h"
+#include "MasterBus.h"
+#include "SpectrumSource.h"
+
+/** The deck/mixer audio graph, independent of any GUI.
+
+    MainComponent plays it through the sound card, and OfflineMixRenderer
+    drives a second instance faster than real time. The mixer keeps a
+    running count of the samples it has produced, which is the clock that
+    control logs are stamped with.
+
+    It also runs tempo sync: before each block, every deck with SYNC on is
+    set to the master deck's tempo, and a phase-lock loop nudges its speed
+    to keep the beats of the two decks lined up.
+
+    Each deck also feeds a post-fader send into a shared convolution
+    reverb, whose return is added to the sum of the decks. The result goes
+    through the master bus (limiter and meter) on its way out.
+
+    Decks with their cue switch on are also heard pre-fader on a headphone
+    bus in output channels 3 and 4, blended with the master. Each deck is
+    added into the master, the send and the cue bus in a single pass over
+    its samples, so pre-listening costs no extra copies.
+*/
+class DJMixer : public AudioSource
+{
+public:
+    DJMixer(AudioFormatManager& formatManager, int numDecks = 2);
+    ~DJMixer() override;
+
+    /** Prepare every deck and the mixer for playback */
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    /** Sum all decks and the reverb return through the master bus into the
+        output buffer and advance the sample clock */
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill) override;
+    /** Release audio resources for every deck and the mixer */
+    void releaseResources() override;
+
+    /** Return the number of decks in the mixer */
+    int getNumDecks() const { return decks.size(); }
+    /** Return the player for the given deck (0-based) */
+    DJAudioPlayer& getDeck(int index) { return *decks[index]; }
+    /** Return the master bus the decks are summed into */
+    MasterBus& getMasterBus() { return masterBus; }
+    /** Return the spectrum analyser on the master output, after the limiter */
+    SpectrumSource& getMasterSpectrum() { return masterSpectrum; }
+
+    /** Load an impulse response into the send reverb (recorded in the control log) */
+    void loadReverbImpulse(const File& file, bool waitUntilLoaded = false);
+    /** Return the file the send reverb's impulse response came from */
+    File getReverbImpulse() const { return reverb.getImpulseResponseFile(); }
+
+    /** Return the number of samples produced since the mixer was created */
+    int64 getSampleClock() const { return sampleClock.load(); }
+    /** Return the sample rate the mixer was last prepared with */
+    double getSampleRate() const { return currentSampleRate; }
+
+    /** Tell every deck whether it is being rendered faster or slower than
+        real time, so it waits for its read-ahead instead of dropping out */
+    void setNonRealtime(bool shouldBeNonRealtime);
+    /** Wait until every deck's read-ahead is ready for the next block.
+        Returns false if any deck still isn't after timeoutMs (audio thread
+        only, between blocks). */
+    bool waitForReadAhead(int numSamples, int timeoutMs);
+
+    /** Route a deck to the cue (PFL) bus on outputs 3 and 4 */
+    void setCueEnabled(int deckIndex, bool shouldCue);
+    /** Check whether a deck is routed to the cue bus */
+    bool isCueEnabled(int deckIndex) const;
+    /** Blend the headphones between the cue bus (0) and the master (1) */
+    void setCueMix(float mix) { cueMix = jlimit(0.0f, 1.0f, mix); }
+    float getCueMix() const { return cueMix; }
+
+    /** Choose the deck synced decks follow, or -1 to pick a playing deck
+        automatically */
+    void setSyncMaster(int deckIndex) { syncMaster = deckIndex; }
+
+    /** Return the mixer sample of the next beat a deck should lock to when it
+        is started or cued with quantise on. Another playing deck with a
+        detected tempo is used as the reference, falling back to the deck's own
+        grid. Returns -1 if nothing is playing with a known tempo. */
+    int64 getNextBeatSample(int deckIndex) const;
+
+    /** Start recording every deck's control changes into the log.
+        The current state of each deck is written first, so the log can
+        be replayed from silence. */
+    void startRecording(ControlLog& log);
+    /** Stop recording and fix the length of the log */
+    void stopRecording();
+    /** Check whether a recording is in progress */
+    bool isRecording() const { return recordingLog != nullptr; }
+
+private:
+    /** Set the speed of every synced deck for the coming block (audio thread) */
+    void updateTempoSync(int numSamples);
+    int findSyncMaster(int followerIndex) const;
+
+    /** Phase-lock loop state for one follower deck */
+    struct SyncState
+    {
+        double integral = 0.0;
+    };
+
+    AudioFormatManager& formatManager;
+
+    OwnedArray<DJAudioPlayer> decks;
+    std::vector<SyncState> syncStates;
+    std::atomic<int> syncMaster { -1 };
+
+    // Send/return bus: each deck is rendered into deckBuffer, added to the
+    // output, and added into sendBuffer at its send level
+    AudioBuffer<float> deckBuffer;
+    AudioBuffer<float> sendBuffer;
+    std::vector<float> appliedSends;
+    std::vector<float> appliedGains;
+    ConvolutionReverb reverb;
+
+    // Cue bus: per-deck switches, and the levels used for the last block
+    std::vector<std::atomic<bool>> cueSwitches;
+    std::vector<float> appliedCues;
+    std::atomic<float> cueMix { 0.0f };
+    float appliedCueMix = 0.0f;
+
+    MasterBus masterBus;
+    SpectrumSource masterSpectrum;
+
+    std::atomic<int64> sampleClock { 0 };
+    double currentSampleRate = 44100.0;
+    int currentBlockSize = 512;
+
+    ControlLog* recordingLog = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DJMixer)
+};
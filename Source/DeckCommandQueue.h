@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.h
+    Created: 18 Oct 2026 2:11:48pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+/** A transport or parameter change for one deck, applied by the audio thread
+    at an exact sample on the mixer clock. */
+struct DeckCommand
+{
+    enum class Type
+    {
+        start,
+        stop,
+        setPosition,    // value = position in seconds
+        setGain,
+        setSpeed,
+        setLowEQ,       // value = gain in dB
+        setMidEQ,
+        setHighEQ,
+        jumpToCue,      // value = cue position in seconds, index = hot cue slot
+        loopIn,
+        loopOut,
+        beatLoop,       // value = loop length in beats
+        loopHalve,
+        loopDouble,
+        loopExit,
+        setSlip,        // value = 1 for on, 0 for off
+        setSync,        // value = 1 for on, 0 for off
+        setFilter,      // value = knob position, -1 to 1
+        setFlanger,     // value = amount, 0 to 1
+        setEcho,
+        setReverbSend,  // value = send level, 0 to 1
+        scratch,        // value = 1 for hand on the platter, 0 for off
+        scratchRate     // value = platter speed, 1 = normal, negative = backwards
+    };
+
+    Type type = Type::start;
+    double value = 0.0;
+    int index = -1;
+
+    /** Mixer sample at which the command takes effect. Anything at or before
+        the start of the block being rendered is applied immediately. */
+    int64 targetSample = 0;
+
+    /** Stamped by the deck when the command is pushed, so commands due at
+        the same sample are applied in the order they were sent */
+    uint32 sequence = 0;
+
+    /** Check whether this was pushed before another command (wraps safely) */
+    bool isBefore(const DeckCommand& other) const noexcept { return (int32) (sequence - other.sequence) < 0; }
+};
+
+/** Wait-free single-producer/single-consumer queue of DeckCommands.
+
+    One thread (the message thread) pushes, the audio thread peeks and pops.
+    Storage is allocated once up front, so neither side ever allocates.
+*/
+class DeckCommandQueue
+{
+public:
+    explicit DeckCommandQueue (int capacity = 256)
+        : fifo (capacity), slots ((size_t) capacity)
+    {
+    }
+
+    /** Add a command. Returns false if the queue is full (producer only). */
+    bool push (const DeckCommand& command) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 + size2 < 1)
+            return false;
+
+        slots[(size_t) (size1 > 0 ? start1 : start2)] = command;
+        fifo.finishedWrite (1);
+        return true;
+    }
+
+    /** Look at the oldest command without removing it (consumer only) */
+    bool peek (DeckCommand& result) const noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (1, start1, size1, start2, size2);
+
+        if (size1 + size2 < 1)
+            return false;
+
+        result = slots[(size_t) (size1 > 0 ? start1 : start2)];
+        return true;
+    }
+
+    /** Remove the oldest command (consumer only) */
+    void pop() noexcept
+    {
+        if (fifo.getNumReady() > 0)
+            fifo.finishedRead (1);
+    }
+
+private:
+    AbstractFifo fifo;
+    std::vector<DeckCommand> slots;
+
+    JUCE_DECLARE_NON_COPYABLE (DeckCommandQueue)
+};
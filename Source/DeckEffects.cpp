@@ -0,0 +1,310 @@
+/*
+  ==============================================================================
+
+    DeckEffects.cpp
+    Created: 18 Oct 2026 5:14:22pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "DeckEffects.h"
+
+namespace
+{
+    // Knob positions closer to the centre than this leave the filter off
+    constexpr float filterDeadZone = 0.02f;
+    constexpr float lowPassMinHz = 150.0f;
+    constexpr float highPassMaxHz = 6000.0f;
+    constexpr float filterResonance = 0.9f;
+    // Coefficients are recalculated this often while the cutoff glides
+    constexpr int filterUpdateInterval = 16;
+
+    constexpr double flangerMaxMs = 12.0;
+    constexpr double flangerCycleBeats = 8.0;
+
+    constexpr double echoMaxSeconds = 2.0;
+    constexpr double echoBeats = 0.5;
+
+    constexpr double fadeSeconds = 0.02;
+}
+
+void DeckEffects::prepare(double newSampleRate, int maximumBlockSize)
+{
+    ignoreUnused(maximumBlockSize);
+    sampleRate = newSampleRate;
+
+    flanger.line.setSize(2, (int) std::ceil(sampleRate * flangerMaxMs * 0.001) + 2);
+    echo.line.setSize(2, (int) std::ceil(sampleRate * echoMaxSeconds) + 2);
+
+    filter.mix.reset(sampleRate, fadeSeconds);
+    flanger.mix.reset(sampleRate, fadeSeconds);
+    echo.send.reset(sampleRate, fadeSeconds);
+    echo.delaySamples.reset(sampleRate, 0.1);
+
+    reset();
+}
+
+void DeckEffects::reset()
+{
+    filter.mix.setCurrentAndTargetValue(filter.amount != 0.0f ? 1.0f : 0.0f);
+    filter.highPass = filter.amount > 0.0f;
+    filter.targetCutoff = getFilterCutoff(filter.amount, filter.highPass);
+    resetFilterState();
+    filter.logCutoff = std::log2(filter.targetCutoff);
+
+    flanger.mix.setCurrentAndTargetValue(flanger.amount);
+    flanger.line.clear();
+    flanger.writePos = 0;
+    flanger.phase = 0.0;
+
+    echo.send.setCurrentAndTargetValue(echo.amount);
+    echo.delaySamples.setCurrentAndTargetValue((float) jlimit(1.0, (double) echo.line.getNumSamples() - 2.0,
+                                                              echoBeats * 60.0 / beatsPerMinute * sampleRate));
+    echo.line.clear();
+    echo.writePos = 0;
+    echo.tailRemaining = 0;
+}
+
+void DeckEffects::setAmount(int slot, float amount)
+{
+    switch (slot)
+    {
+        case filterSlot:
+        {
+            const bool wasActive = isFilterActive();
+            amount = jlimit(-1.0f, 1.0f, amount);
+            filter.amount = std::abs(amount) < filterDeadZone ? 0.0f : amount;
+
+            if (filter.amount != 0.0f)
+            {
+                const bool highPass = filter.amount > 0.0f;
+
+                if (! wasActive)
+                {
+                    filter.highPass = highPass;
+                    resetFilterState();
+                }
+
+                // Crossing to the other mode fades this one out first;
+                // processFilter() switches over once it is silent
+                if (highPass == filter.highPass)
+                    filter.targetCutoff = getFilterCutoff(filter.amount, highPass);
+            }
+
+            filter.mix.setTargetValue(filter.amount != 0.0f && (filter.amount > 0.0f) == filter.highPass
+                                          ? 1.0f : 0.0f);
+            break;
+        }
+
+        case flangerSlot:
+            flanger.amount = jlimit(0.0f, 1.0f, amount);
+            flanger.mix.setTargetValue(flanger.amount);
+            break;
+
+        case echoSlot:
+        {
+            const float previous = echo.amount;
+            echo.amount = jlimit(0.0f, 1.0f, amount);
+            echo.send.setTargetValue(echo.amount);
+
+            // Let the repeats die away (to -60 dB) before going idle
+            if (echo.amount > 0.0f)
+            {
+                echo.feedback = 0.3f + 0.4f * echo.amount;
+                echo.tailRemaining = 0;
+            }
+            else if (previous > 0.0f)
+            {
+                const int repeats = (int) std::ceil(std::log(0.001f) / std::log(echo.feedback));
+                echo.tailRemaining = roundToInt(repeats * echo.delaySamples.getTargetValue()
+                                                + fadeSeconds * sampleRate);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void DeckEffects::setTempo(double bpm)
+{
+    beatsPerMinute = bpm > 0.0 ? bpm : 120.0;
+
+    const double delay = echoBeats * 60.0 / beatsPerMinute * sampleRate;
+    echo.delaySamples.setTargetValue((float) jlimit(1.0, (double) echo.line.getNumSamples() - 2.0, delay));
+}
+
+void DeckEffects::process(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (numSamples <= 0 || buffer.getNumChannels() <= 0) return;
+
+    if (isFilterActive())  processFilter(buffer, startSample, numSamples);
+    if (isFlangerActive()) processFlanger(buffer, startSample, numSamples);
+    if (isEchoActive())    processEcho(buffer, startSample, numSamples);
+}
+
+float DeckEffects::getFilterCutoff(float amount, bool highPass)
+{
+    if (highPass)
+        return 20.0f * std::pow(highPassMaxHz / 20.0f, jmax(0.0f, amount));
+
+    return 20000.0f * std::pow(lowPassMinHz / 20000.0f, jmax(0.0f, -amount));
+}
+
+void DeckEffects::resetFilterState()
+{
+    filter.logCutoff = std::log2(getFilterCutoff(0.0f, filter.highPass));
+    for (int ch = 0; ch < 2; ++ch)
+        filter.ic1[ch] = filter.ic2[ch] = 0.0f;
+}
+
+void DeckEffects::processFilter(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const int numChannels = jmin(2, buffer.getNumChannels());
+    const bool highPass = filter.highPass;
+    const float k = 1.0f / filterResonance;
+    const float targetLogCutoff = std::log2(filter.targetCutoff);
+    const float maxLogCutoff = std::log2((float) sampleRate * 0.45f);
+    const float glide = 1.0f - std::exp(-(float) filterUpdateInterval / (0.01f * (float) sampleRate));
+
+    float* channels[2] = { buffer.getWritePointer(0, startSample),
+                           buffer.getWritePointer(numChannels - 1, startSample) };
+
+    for (int done = 0; done < numSamples; done += filterUpdateInterval)
+    {
+        const int count = jmin(filterUpdateInterval, numSamples - done);
+
+        filter.logCutoff += (targetLogCutoff - filter.logCutoff) * glide;
+        const float cutoff = std::exp2(jmin(filter.logCutoff, maxLogCutoff));
+
+        const float g = std::tan(MathConstants<float>::pi * cutoff / (float) sampleRate);
+        const float a1 = 1.0f / (1.0f + g * (g + k));
+        const float a2 = g * a1;
+        const float a3 = g * a2;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const float mix = filter.mix.getNextValue();
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                float& s = channels[ch][done + i];
+                const float x = s;
+
+                const float v3 = x - filter.ic2[ch];
+                const float v1 = a1 * filter.ic1[ch] + a2 * v3;
+                const float v2 = filter.ic2[ch] + a2 * filter.ic1[ch] + a3 * v3;
+                filter.ic1[ch] = 2.0f * v1 - filter.ic1[ch];
+                filter.ic2[ch] = 2.0f * v2 - filter.ic2[ch];
+
+                const float y = highPass ? x - k * v1 - v2 : v2;
+                s = x + mix * (y - x);
+            }
+        }
+    }
+
+    if (filter.mix.isSmoothing() || filter.mix.getCurrentValue() > 0.0f)
+        return;
+
+    // Faded out: start from rest, fully open, the next time the knob moves
+    // off the centre, or now in the other mode if it crossed over
+    if (filter.amount != 0.0f)
+    {
+        filter.highPass = filter.amount > 0.0f;
+        filter.targetCutoff = getFilterCutoff(filter.amount, filter.highPass);
+        filter.mix.setTargetValue(1.0f);
+    }
+
+    resetFilterState();
+}
+
+void DeckEffects::processFlanger(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const int numChannels = jmin(2, buffer.getNumChannels());
+    const int lineLength = flanger.line.getNumSamples();
+    const double phaseStep = MathConstants<double>::twoPi
+                           / (flangerCycleBeats * 60.0 / beatsPerMinute * sampleRate);
+    const float minDelay = (float) (0.001 * sampleRate);
+    const float sweep = (float) ((flangerMaxMs - 1.5) * 0.001 * sampleRate);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float mix = flanger.mix.getNextValue();
+        const float feedback = 0.7f * mix;
+
+        // The right channel sweeps a quarter cycle behind for width
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const double lfo = 0.5 - 0.5 * std::cos(flanger.phase - ch * MathConstants<double>::halfPi);
+            const float delay = minDelay + sweep * mix * (float) lfo;
+
+            float readPos = (float) flanger.writePos - delay;
+            if (readPos < 0.0f) readPos += (float) lineLength;
+
+            const int i0 = (int) readPos;
+            const int i1 = (i0 + 1) % lineLength;
+            const float frac = readPos - (float) i0;
+            const auto* line = flanger.line.getReadPointer(ch);
+            const float delayed = line[i0] + frac * (line[i1] - line[i0]);
+
+            float& s = buffer.getWritePointer(ch, startSample)[i];
+            flanger.line.setSample(ch, flanger.writePos, s + feedback * delayed);
+            s = (1.0f - 0.5f * mix) * s + 0.5f * mix * delayed;
+        }
+
+        flanger.writePos = (flanger.writePos + 1) % lineLength;
+        flanger.phase += phaseStep;
+        if (flanger.phase >= MathConstants<double>::twoPi)
+            flanger.phase -= MathConstants<double>::twoPi;
+    }
+
+    if (! isFlangerActive())
+        flanger.line.clear();
+}
+
+void DeckEffects::processEcho(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const int numChannels = jmin(2, buffer.getNumChannels());
+    const int lineLength = echo.line.getNumSamples();
+    const float feedback = echo.feedback;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float send = echo.send.getNextValue();
+        const float delay = echo.delaySamples.getNextValue();
+
+        float readPos = (float) echo.writePos - delay;
+        if (readPos < 0.0f) readPos += (float) lineLength;
+
+        const int i0 = (int) readPos;
+        const int i1 = (i0 + 1) % lineLength;
+        const float frac = readPos - (float) i0;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* line = echo.line.getReadPointer(ch);
+            const float delayed = line[i0] + frac * (line[i1] - line[i0]);
+
+            float& s = buffer.getWritePointer(ch, startSample)[i];
+            echo.line.setSample(ch, echo.writePos, send * s + feedback * delayed);
+            s += delayed;
+        }
+
+        echo.writePos = (echo.writePos + 1) % lineLength;
+    }
+
+    if (echo.amount <= 0.0f && ! echo.send.isSmoothing())
+    {
+        echo.tailRemaining -= numSamples;
+
+        // The repeats have died away: clear the line once and go idle
+        if (echo.tailRemaining <= 0)
+        {
+            echo.tailRemaining = 0;
+            echo.line.clear();
+            echo.writePos = 0;
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    DeckEffects.h
+    Created: 18 Oct 2026 5:14:22pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** A deck's FX rack: a filter sweep, a flanger and a beat-synced echo, in
+    that order, each on one knob.
+
+    Every buffer is allocated in prepare(), so amounts and tempo can change
+    from the audio thread at any time. An effect whose knob is at zero fades
+    out, lets its tail ring out (for the echo), and is then skipped
+    entirely, so a bypassed slot costs one branch per block.
+*/
+class DeckEffects
+{
+public:
+    enum Slot { filterSlot = 0, flangerSlot, echoSlot, numSlots };
+
+    /** Allocate the delay lines for the given sample rate (not while processing) */
+    void prepare(double sampleRate, int maximumBlockSize);
+    /** Silence every effect and clear its state */
+    void reset();
+
+    /** Set an effect's knob (audio thread). The filter is bipolar: below 0
+        sweeps a low-pass down, above 0 sweeps a high-pass up. The flanger
+        and echo run from 0 (off) to 1. */
+    void setAmount(int slot, float amount);
+    /** Set the tempo the flanger and echo lock to, in output beats per minute */
+    void setTempo(double bpm);
+
+    /** Process a stereo block in place (audio thread) */
+    void process(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+private:
+    /** Zavalishin's topology-preserving state-variable filter */
+    struct Filter
+    {
+        float amount = 0.0f;
+        SmoothedValue<float, ValueSmoothingTypes::Linear> mix;
+        // The mode and cutoff last set off the centre, kept until mix is 0
+        bool highPass = false;
+        float targetCutoff = 20000.0f;
+        float logCutoff = 0.0f;   // smoothed, in log2(Hz)
+        float ic1[2] = { 0.0f, 0.0f }, ic2[2] = { 0.0f, 0.0f };
+    };
+
+    struct Flanger
+    {
+        float amount = 0.0f;
+        SmoothedValue<float, ValueSmoothingTypes::Linear> mix;
+        AudioBuffer<float> line;
+        int writePos = 0;
+        double phase = 0.0;
+    };
+
+    struct Echo
+    {
+        float amount = 0.0f;
+        SmoothedValue<float, ValueSmoothingTypes::Linear> send;
+        SmoothedValue<float, ValueSmoothingTypes::Multiplicative> delaySamples;
+        AudioBuffer<float> line;
+        float feedback = 0.3f;
+        int writePos = 0;
+        int tailRemaining = 0;   // samples left before a switched-off echo goes idle
+    };
+
+    void processFilter(AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void processFlanger(AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void processEcho(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /** Return the cutoff for a knob position; 0 is fully open for either mode */
+    static float getFilterCutoff(float amount, bool highPass);
+    /** Start the filter from rest in its current mode, fully open */
+    void resetFilterState();
+    bool isFilterActive() const  { return filter.amount != 0.0f || filter.mix.isSmoothing(); }
+    bool isFlangerActive() const { return flanger.amount > 0.0f || flanger.mix.isSmoothing(); }
+    bool isEchoActive() const    { return echo.amount > 0.0f || echo.send.isSmoothing() || echo.tailRemaining > 0; }
+
+    double sampleRate = 44100.0;
+    double beatsPerMinute = 120.0;
+
+    Filter filter;
+    Flanger flanger;
+    Echo echo;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckEffects)
+};
@@ -47,9 +47,11 @@ static void styleRotaryKnob(Slider& s, Colour fill, Colour outline = Colours::wh
 //==============================================================================
 
 DeckGUI::DeckGUI(DJAudioPlayer* _player,
-                 AudioFormatManager& formatManagerToUse,
-                 AudioThumbnailCache& cacheToUse)
-    : waveformDisplay(formatManagerToUse, cacheToUse),
+                 AudioFormatManager& formatManagerToUse)
+    : waveformDisplay(formatManagerToUse),
+      spectrumDisplay(_player->getSpectrum()),
+      nextWaveform(formatManagerToUse),
+      levelMeter(_player->getMeter()),
       player(_player)
 {
     addAndMakeVisible(playButton);
@@ -61,6 +63,16 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     addAndMakeVisible(posSlider);
 
     addAndMakeVisible(waveformDisplay);
+    addAndMakeVisible(scrollingWaveform);
+    addAndMakeVisible(spectrumDisplay);
+    addAndMakeVisible(jogWheel);
+    jogWheel.onTouch = [this](bool isTouching) { player->setScratchTouch(isTouching); };
+    jogWheel.onRateChange = [this](double rate) { player->setScratchRate(rate); };
+    jogWheel.getPositionSeconds = [this] { return playheadSeconds; };
+    addAndMakeVisible(nextWaveform);
+    addAndMakeVisible(loadNextButton);
+    loadNextButton.setEnabled(false);
+    addAndMakeVisible(levelMeter);
 
     addAndMakeVisible(lowEQSlider);
     addAndMakeVisible(midEQSlider);
@@ -70,9 +82,30 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     addAndMakeVisible(midEQLabel);
     addAndMakeVisible(highEQLabel);
 
+    for (auto* s : { &filterKnob, &flangerKnob, &echoKnob, &reverbKnob })
+    {
+        addAndMakeVisible(s);
+        s->addListener(this);
+    }
+
+    addAndMakeVisible(filterLabel);
+    addAndMakeVisible(flangerLabel);
+    addAndMakeVisible(echoLabel);
+    addAndMakeVisible(reverbLabel);
+
     addAndMakeVisible(cueModeButton);
     addAndMakeVisible(clearCuesButton);
 
+    for (auto* b : { &loopInButton, &loopOutButton, &beatLoopButton,
+                     &halveLoopButton, &doubleLoopButton, &exitLoopButton })
+    {
+        addAndMakeVisible(b);
+        b->addListener(this);
+    }
+
+    addAndMakeVisible(slipButton);
+    slipButton.addListener(this);
+
     // ✅ BPM label
     addAndMakeVisible(bpmLabel);
     bpmLabel.setJustificationType(Justification::centredRight);
@@ -80,6 +113,17 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     bpmLabel.setColour(Label::textColourId, Colours::white.withAlpha(0.85f));
     bpmLabel.setText("BPM: --", dontSendNotification);
 
+    addAndMakeVisible(quantiseButton);
+    quantiseButton.setColour(ToggleButton::textColourId, Colours::white.withAlpha(0.85f));
+
+    addAndMakeVisible(syncButton);
+    syncButton.setColour(ToggleButton::textColourId, Colours::white.withAlpha(0.85f));
+    syncButton.addListener(this);
+
+    addAndMakeVisible(pflButton);
+    pflButton.setColour(ToggleButton::textColourId, Colours::white.withAlpha(0.85f));
+    pflButton.addListener(this);
+
     for (auto& btn : hotCueButtons)
     {
         addAndMakeVisible(btn);
@@ -89,6 +133,7 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     playButton.addListener(this);
     stopButton.addListener(this);
     loadButton.addListener(this);
+    loadNextButton.addListener(this);
 
     clearCuesButton.addListener(this);
     cueModeButton.addListener(this);
@@ -131,6 +176,26 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     styleBandLabel(midEQLabel, "MID");
     styleBandLabel(highEQLabel, "HIGH");
 
+    auto setupFX = [](Slider& s, double minimum)
+    {
+        s.setSliderStyle(Slider::RotaryHorizontalVerticalDrag);
+        s.setTextBoxStyle(Slider::NoTextBox, false, 0, 0);
+        s.setRange(minimum, 1.0, 0.01);
+        s.setValue(0.0);
+        s.setDoubleClickReturnValue(true, 0.0);
+    };
+
+    // The filter is bipolar: left of centre is low-pass, right is high-pass
+    setupFX(filterKnob, -1.0);
+    setupFX(flangerKnob, 0.0);
+    setupFX(echoKnob, 0.0);
+    setupFX(reverbKnob, 0.0);
+
+    styleBandLabel(filterLabel, "FILTER");
+    styleBandLabel(flangerLabel, "FLANGER");
+    styleBandLabel(echoLabel, "ECHO");
+    styleBandLabel(reverbLabel, "REVERB");
+
     const Colour btnBase   = Colour(0xff1f2937);
     const Colour btnAlt    = Colour(0xff0f172a);
     const Colour accent    = Colour(0xff00aaff);    // cyan
@@ -141,8 +206,18 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     styleButton(playButton, btnBase);
     styleButton(stopButton, btnBase);
     styleButton(loadButton, btnBase);
+    styleButton(loadNextButton, btnAlt);
     styleButton(clearCuesButton, btnAlt);
 
+    for (auto* b : { &loopInButton, &loopOutButton, &beatLoopButton,
+                     &halveLoopButton, &doubleLoopButton, &exitLoopButton })
+    {
+        styleButton(*b, btnAlt);
+        b->setColour(TextButton::buttonOnColourId, Colour(0xff22c55e).withAlpha(0.45f));
+    }
+
+    slipButton.setColour(ToggleButton::textColourId, Colours::white.withAlpha(0.90f));
+
     clearCuesButton.setColour(TextButton::buttonOnColourId, accent.withAlpha(0.25f));
     cueModeButton.setColour(ToggleButton::textColourId, Colours::white.withAlpha(0.90f));
 
@@ -161,6 +236,9 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     midEQLabel.setColour(Label::textColourId,  Colours::white.withAlpha(0.88f));
     highEQLabel.setColour(Label::textColourId, highCol.withAlpha(0.92f));
 
+    for (auto* s : { &filterKnob, &flangerKnob, &echoKnob, &reverbKnob })
+        styleRotaryKnob(*s, accent);
+
     initHotCues();
     updateHotCueButtonLabels();
 
@@ -214,22 +292,32 @@ void DeckGUI::resized()
 
     const int cueTopH     = controlH;
     const int cuesGridH   = 80;
+    const int loopRowH    = controlH;
     const int loadH       = controlH;
+    const int nextH       = 26;
+    const int meterH      = 16;
 
     const int transportH  = controlH * 2 + smallGap;
     const int slidersH    = controlH * 3 + smallGap*2;
 
     int eqH       = 120;
     int waveformH = 60;
+    int scrollH   = 70;
+    int spectrumH = 48;
+    int fxH       = 64;
 
     const int requiredFixed =
-        transportH + gap +
+        transportH + meterH + smallGap + gap +
         slidersH   + gap +
+        gap +
         cueTopH    + smallGap +
         cuesGridH  + gap +
+        loopRowH   + gap +
+        nextH      + smallGap +
         loadH;
 
-    int remaining = area.getHeight() - requiredFixed;
+    int remaining = area.getHeight() - requiredFixed - eqH - fxH - waveformH - scrollH - smallGap
+                    - spectrumH - smallGap;
 
     if (remaining < 0)
     {
@@ -237,10 +325,16 @@ void DeckGUI::resized()
 
         const int minEqH = 80;
         const int minWaveH = 30;
+        const int minScrollH = 36;
 
         int eqReducible = eqH - minEqH;
         int waveReducible = waveformH - minWaveH;
 
+        // The spectrum is the first thing to go on a small screen
+        int takeFromSpectrum = jmin(spectrumH, shortBy);
+        spectrumH -= takeFromSpectrum;
+        shortBy -= takeFromSpectrum;
+
         int takeFromEq = jmin(eqReducible, shortBy);
         eqH -= takeFromEq;
         shortBy -= takeFromEq;
@@ -248,6 +342,15 @@ void DeckGUI::resized()
         int takeFromWave = jmin(waveReducible, shortBy);
         waveformH -= takeFromWave;
         shortBy -= takeFromWave;
+
+        int takeFromScroll = jmin(scrollH - minScrollH, shortBy);
+        scrollH -= takeFromScroll;
+        shortBy -= takeFromScroll;
+
+        const int minFxH = 40;
+        int takeFromFx = jmin(fxH - minFxH, shortBy);
+        fxH -= takeFromFx;
+        shortBy -= takeFromFx;
     }
 
     // Transport
@@ -258,6 +361,13 @@ void DeckGUI::resized()
     // ✅ BPM label row (always visible)
     auto bpmRow = area.removeFromTop(18);
     bpmLabel.setBounds(bpmRow.removeFromRight(140));
+    quantiseButton.setBounds(bpmRow.removeFromLeft(110));
+    syncButton.setBounds(bpmRow.removeFromLeft(80));
+    pflButton.setBounds(bpmRow.removeFromLeft(70));
+
+    // Deck output level
+    area.removeFromTop(smallGap);
+    levelMeter.setBounds(area.removeFromTop(meterH));
 
     area.removeFromTop(gap);
 
@@ -296,6 +406,29 @@ void DeckGUI::resized()
 
     area.removeFromTop(gap);
 
+    // FX
+    auto fxArea = area.removeFromTop(fxH);
+    const int fxLabelH = 14;
+    const int fxColW = fxArea.getWidth() / 4;
+    const int fxKnobSize = jmax(20, fxArea.getHeight() - fxLabelH);
+
+    auto layoutFX = [&](int idx, Label& label, Slider& knob)
+    {
+        Rectangle<int> col(fxArea.getX() + idx * fxColW, fxArea.getY(), fxColW, fxArea.getHeight());
+
+        label.setBounds(col.removeFromTop(fxLabelH));
+        label.setJustificationType(Justification::centred);
+
+        knob.setBounds(col.getX() + (col.getWidth() - fxKnobSize) / 2, col.getY(), fxKnobSize, fxKnobSize);
+    };
+
+    layoutFX(0, filterLabel,  filterKnob);
+    layoutFX(1, flangerLabel, flangerKnob);
+    layoutFX(2, echoLabel,    echoKnob);
+    layoutFX(3, reverbLabel,  reverbKnob);
+
+    area.removeFromTop(gap);
+
     // Cue top
     auto cueTop = area.removeFromTop(cueTopH);
     cueModeButton.setBounds(cueTop.removeFromLeft(cueTop.getWidth() / 2).reduced(4));
@@ -324,8 +457,39 @@ void DeckGUI::resized()
 
     area.removeFromTop(gap);
 
-    // Waveform
-    waveformDisplay.setBounds(area.removeFromTop(waveformH));
+    // Loop row
+    auto loopRow = area.removeFromTop(loopRowH);
+    const int loopW = loopRow.getWidth() / 7;
+
+    for (auto* b : { &loopInButton, &loopOutButton, &beatLoopButton,
+                     &halveLoopButton, &doubleLoopButton, &exitLoopButton })
+        b->setBounds(loopRow.removeFromLeft(loopW).reduced(3));
+
+    slipButton.setBounds(loopRow.reduced(3));
+
+    area.removeFromTop(gap);
+
+    // Zoomed waveform around the playhead
+    scrollingWaveform.setBounds(area.removeFromTop(scrollH));
+    area.removeFromTop(smallGap);
+
+    // Spectrum analyser
+    spectrumDisplay.setVisible(spectrumH > 0);
+    spectrumDisplay.setBounds(area.removeFromTop(spectrumH));
+    area.removeFromTop(smallGap);
+
+    // Jog wheel and waveform
+    auto waveRow = area.removeFromTop(waveformH);
+    jogWheel.setBounds(waveRow.removeFromLeft(waveformH));
+    waveRow.removeFromLeft(smallGap);
+    waveformDisplay.setBounds(waveRow);
+    area.removeFromTop(smallGap);
+
+    // Next track preview
+    auto nextRow = area.removeFromTop(nextH);
+    loadNextButton.setBounds(nextRow.removeFromRight(110));
+    nextRow.removeFromRight(smallGap);
+    nextWaveform.setBounds(nextRow);
     area.removeFromTop(smallGap);
 
     // Load
@@ -342,8 +506,32 @@ void DeckGUI::updateBpmLabel()
         return;
     }
 
-    const double b = player->getBpm(); // make sure DJAudioPlayer has getBpm()
-    bpmLabel.setText(b > 0.0 ? ("BPM: " + String(b, 1)) : "BPM: --", dontSendNotification);
+    // Read from the deck's snapshot, which takes no lock
+    const auto clock = player->getBeatClock();
+    const bool synced = clock.bpm > 0.0 && player->getSync();
+
+    // While synced, show the tempo the deck is actually playing at
+    const double b = synced ? clock.bpm * clock.tempoRatio : clock.bpm;
+
+    // Only rebuild the text when what it shows has changed
+    if (std::abs(b - shownBpm) < 0.05 && synced == shownSync)
+        return;
+
+    shownBpm = b;
+    shownSync = synced;
+
+    if (synced)
+        bpmLabel.setText("BPM: " + String(b, 1) + " SYNC", dontSendNotification);
+    else
+        bpmLabel.setText(b > 0.0 ? ("BPM: " + String(b, 1)) : "BPM: --", dontSendNotification);
+}
+
+int64 DeckGUI::getQuantisedTarget() const
+{
+    if (!quantiseButton.getToggleState() || getNextBeatSample == nullptr)
+        return -1;
+
+    return getNextBeatSample();
 }
 
 void DeckGUI::loadFile(File file)
@@ -351,10 +539,14 @@ void DeckGUI::loadFile(File file)
     if (!file.existsAsFile())
         return;
 
+    if (eqNeedsSaving)
+        saveEQForCurrentTrack();
+
     loadedTrackPath = file.getFullPathName();
 
     player->loadURL(URL{ file });
     waveformDisplay.loadURL(URL{ file });
+    scrollingWaveform.setPyramid(waveformDisplay.getPyramid());
 
     loadHotCuesForCurrentTrack();
     loadEQForCurrentTrack();
@@ -364,6 +556,20 @@ void DeckGUI::loadFile(File file)
     repaint();
 }
 
+void DeckGUI::queueFile(File file)
+{
+    if (!file.existsAsFile())
+        return;
+
+    queuedTrackPath = file.getFullPathName();
+
+    // The preview builds the waveform now, and hands it to the main
+    // displays when the track is swapped in
+    player->queueURL(URL{ file });
+    nextWaveform.loadURL(URL{ file });
+    loadNextButton.setEnabled(false);
+}
+
 void DeckGUI::buttonClicked(Button* button)
 {
     const Colour btnBase     = Colour(0xff1f2937);
@@ -373,7 +579,10 @@ void DeckGUI::buttonClicked(Button* button)
 
     if (button == &playButton)
     {
-        player->start();
+        const int64 beat = getQuantisedTarget();
+        if (beat >= 0) player->startAt(beat);
+        else           player->start();
+
         playButton.setColour(TextButton::buttonColourId, accent.withAlpha(0.42f));
         stopButton.setColour(TextButton::buttonColourId, btnBase);
         repaint();
@@ -402,6 +611,50 @@ void DeckGUI::buttonClicked(Button* button)
         return;
     }
 
+    if (button == &loadNextButton)
+    {
+        if (queuedTrackPath.isEmpty() || !player->loadQueued())
+            return;
+
+        if (eqNeedsSaving)
+            saveEQForCurrentTrack();
+
+        File file{ queuedTrackPath };
+        queuedTrackPath.clear();
+        loadedTrackPath = file.getFullPathName();
+
+        waveformDisplay.setPyramid(nextWaveform.takePyramid());
+        scrollingWaveform.setPyramid(waveformDisplay.getPyramid());
+        loadNextButton.setEnabled(false);
+
+        loadHotCuesForCurrentTrack();
+        loadEQForCurrentTrack();
+        updateBpmLabel();
+        repaint();
+        return;
+    }
+
+    if (button == &loopInButton)     { player->setLoopIn();    return; }
+    if (button == &loopOutButton)    { player->setLoopOut();   return; }
+    if (button == &halveLoopButton)  { player->halveLoop();    return; }
+    if (button == &doubleLoopButton) { player->doubleLoop();   return; }
+    if (button == &exitLoopButton)   { player->exitLoop();     return; }
+    if (button == &slipButton)       { player->setSlipMode(slipButton.getToggleState()); return; }
+    if (button == &syncButton)       { player->setSync(syncButton.getToggleState()); return; }
+
+    if (button == &pflButton)
+    {
+        if (onCueToggled != nullptr) onCueToggled(pflButton.getToggleState());
+        return;
+    }
+
+    if (button == &beatLoopButton)
+    {
+        const int64 beat = player->isPlaying() ? getQuantisedTarget() : -1;
+        player->startBeatLoop(4.0, jmax((int64) 0, beat));
+        return;
+    }
+
     if (button == &clearCuesButton)
     {
         clearAllHotCues();
@@ -416,6 +669,7 @@ void DeckGUI::buttonClicked(Button* button)
             if (cueModeButton.getToggleState())
             {
                 hotCues[i] = player->getPositionRelative();
+                player->setHotCue(i, hotCues[i]);
                 saveHotCuesForCurrentTrack();
 
                 hotCueButtons[i].setColour(TextButton::buttonColourId, cueAssign.withAlpha(0.35f));
@@ -430,7 +684,8 @@ void DeckGUI::buttonClicked(Button* button)
             {
                 if (hotCues[i] >= 0.0)
                 {
-                    player->setPositionRelative(hotCues[i]);
+                    const int64 beat = player->isPlaying() ? getQuantisedTarget() : -1;
+                    player->jumpToHotCue(i, jmax((int64) 0, beat));
 
                     hotCueButtons[i].setColour(TextButton::buttonColourId, cueGlow.withAlpha(0.38f));
                     hotCueButtons[i].setColour(TextButton::buttonOnColourId, cueGlow.withAlpha(0.50f));
@@ -454,6 +709,11 @@ void DeckGUI::sliderValueChanged(Slider* slider)
     if (slider == &speedSlider) player->setSpeed(slider->getValue());
     if (slider == &posSlider)   player->setPositionRelative(slider->getValue());
 
+    if (slider == &filterKnob)  player->setFilterAmount((float) slider->getValue());
+    if (slider == &flangerKnob) player->setFlangerAmount((float) slider->getValue());
+    if (slider == &echoKnob)    player->setEchoAmount((float) slider->getValue());
+    if (slider == &reverbKnob)  player->setReverbSend((float) slider->getValue());
+
     if (slider == &lowEQSlider || slider == &midEQSlider || slider == &highEQSlider)
     {
         lowDb  = lowEQSlider.getValue();
@@ -461,7 +721,7 @@ void DeckGUI::sliderValueChanged(Slider* slider)
         highDb = highEQSlider.getValue();
 
         applyEQToPlayer();
-        saveEQForCurrentTrack();
+        markEQChanged();
     }
 }
 
@@ -474,13 +734,82 @@ void DeckGUI::filesDropped(const StringArray& files, int, int)
 
 void DeckGUI::timerCallback()
 {
-    const double pos = player->getPositionRelative();
-    waveformDisplay.setPositionRelative(pos);
-    posSlider.setValue(pos, dontSendNotification);
+    beatLoopButton.setToggleState(player->getBeatClock().looping, dontSendNotification);
+    followPlayerControls();
+
+    if (eqNeedsSaving && Time::getMillisecondCounter() - eqChangedAtMs >= eqSaveDelayMs)
+        saveEQForCurrentTrack();
+
+    if (queuedTrackPath.isNotEmpty())
+    {
+        // The queued track failed to open
+        if (player->getQueuedURL().isEmpty())
+        {
+            queuedTrackPath.clear();
+            nextWaveform.clear();
+        }
+
+        loadNextButton.setEnabled(player->isQueuedTrackReady());
+    }
 
     updateBpmLabel(); // ✅ keeps BPM label correct even if you reload etc.
 }
 
+void DeckGUI::updatePlayhead()
+{
+    const auto clock = player->getBeatClock();
+    playheadSeconds = clock.getPositionAt(Time::getMillisecondCounterHiRes());
+
+    const double pos = clock.lengthSec > 0.0 ? playheadSeconds / clock.lengthSec : 0.0;
+    waveformDisplay.setPositionRelative(pos);
+    scrollingWaveform.setPositionSeconds(playheadSeconds);
+
+    // The slider repaints on every change, so only move it a whole pixel at a time
+    if (! posSlider.isMouseButtonDown() && std::abs(posSlider.getValue() - pos) * posSlider.getWidth() >= 1.0)
+        posSlider.setValue(pos, dontSendNotification);
+}
+
+void DeckGUI::followPlayerControls()
+{
+    auto follow = [](Slider& s, double value)
+    {
+        if (! s.isMouseButtonDown() && std::abs(s.getValue() - value) > 1.0e-6)
+            s.setValue(value, dontSendNotification);
+    };
+
+    follow(volSlider, player->getGain());
+    follow(speedSlider, player->getSpeed());
+    follow(filterKnob, player->getFilterAmount());
+    follow(flangerKnob, player->getFlangerAmount());
+    follow(echoKnob, player->getEchoAmount());
+    follow(reverbKnob, player->getReverbSend());
+
+    // EQ moves made on the controller are remembered for the track too
+    const double low  = player->getLowEQGainDb();
+    const double mid  = player->getMidEQGainDb();
+    const double high = player->getHighEQGainDb();
+
+    auto moved = [](double a, double b) { return std::abs(a - b) > 0.01; };
+
+    if (moved(low, sentLowDb) || moved(mid, sentMidDb) || moved(high, sentHighDb))
+    {
+        lowDb  = sentLowDb  = low;
+        midDb  = sentMidDb  = mid;
+        highDb = sentHighDb = high;
+
+        follow(lowEQSlider, lowDb);
+        follow(midEQSlider, midDb);
+        follow(highEQSlider, highDb);
+        markEQChanged();
+    }
+}
+
+void DeckGUI::markEQChanged()
+{
+    eqNeedsSaving = true;
+    eqChangedAtMs = Time::getMillisecondCounter();
+}
+
 // ==========================
 // HOT CUES IMPLEMENTATION
 // ==========================
@@ -493,9 +822,17 @@ void DeckGUI::initHotCues()
 void DeckGUI::clearAllHotCues()
 {
     for (auto& c : hotCues) c = -1.0;
+    sendHotCuesToPlayer();
     updateHotCueButtonLabels();
 }
 
+void DeckGUI::sendHotCuesToPlayer()
+{
+    // The player pre-decodes the audio after each cue so jumps are instant
+    for (int i = 0; i < 8; ++i)
+        player->setHotCue(i, hotCues[(size_t)i]);
+}
+
 void DeckGUI::updateHotCueButtonLabels()
 {
     for (int i = 0; i < 8; ++i)
@@ -552,6 +889,7 @@ void DeckGUI::loadHotCuesForCurrentTrack()
     for (int i = 0; i < jmin(8, arr->size()); ++i)
         hotCues[(size_t)i] = (double)(*arr)[i];
 
+    sendHotCuesToPlayer();
     updateHotCueButtonLabels();
 }
 
@@ -607,35 +945,38 @@ void DeckGUI::applyEQToPlayer()
     player->setLowEQGainDb((float) lowDb);
     player->setMidEQGainDb((float) midDb);
     player->setHighEQGainDb((float) highDb);
+
+    sentLowDb  = lowDb;
+    sentMidDb  = midDb;
+    sentHighDb = highDb;
 }
 
 void DeckGUI::loadEQForCurrentTrack()
 {
-    lowDb  = 0.0;
-    midDb  = 0.0;
-    highDb = 0.0;
+    // A track without a saved entry plays flat, whatever the last track used
+    lowDb  = midDb  = highDb  = 0.0;
+    originalLowDb = originalMidDb = originalHighDb = 0.0;
+    eqNeedsSaving = false;
 
-    if (loadedTrackPath.isEmpty()) return;
+    DynamicObject* eq = nullptr;
 
-    var root = loadEQJson();
-    if (!root.isObject()) return;
-
-    auto* obj = root.getDynamicObject();
-    if (obj == nullptr) return;
-
-    var trackData = obj->getProperty(loadedTrackPath);
-    if (!trackData.isObject()) return;
-
-    auto* eq = trackData.getDynamicObject();
-    if (eq == nullptr) return;
+    if (loadedTrackPath.isNotEmpty())
+    {
+        var root = loadEQJson();
+        if (auto* obj = root.getDynamicObject())
+            eq = obj->getProperty(loadedTrackPath).getDynamicObject();
+    }
 
-    lowDb  = (double) eq->getProperty("low");
-    midDb  = (double) eq->getProperty("mid");
-    highDb = (double) eq->getProperty("high");
+    if (eq != nullptr)
+    {
+        lowDb  = (double) eq->getProperty("low");
+        midDb  = (double) eq->getProperty("mid");
+        highDb = (double) eq->getProperty("high");
 
-    originalLowDb  = (double) eq->getProperty("originalLow");
-    originalMidDb  = (double) eq->getProperty("originalMid");
-    originalHighDb = (double) eq->getProperty("originalHigh");
+        originalLowDb  = (double) eq->getProperty("originalLow");
+        originalMidDb  = (double) eq->getProperty("originalMid");
+        originalHighDb = (double) eq->getProperty("originalHigh");
+    }
 
     lowEQSlider.setValue(lowDb, dontSendNotification);
     midEQSlider.setValue(midDb, dontSendNotification);
@@ -646,6 +987,8 @@ void DeckGUI::loadEQForCurrentTrack()
 
 void DeckGUI::saveEQForCurrentTrack()
 {
+    eqNeedsSaving = false;
+
     if (loadedTrackPath.isEmpty()) return;
 
     var root = loadEQJson();
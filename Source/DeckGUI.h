@@ -12,6 +12,10 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "DJAudioPlayer.h"
 #include "WaveformDisplay.h"
+#include "ScrollingWaveform.h"
+#include "SpectrumDisplay.h"
+#include "JogWheel.h"
+#include "LevelMeter.h"
 #include <array>
 
 class DeckGUI : public juce::Component,
@@ -23,8 +27,7 @@ class DeckGUI : public juce::Component,
 public:
     /** Create a deck GUI linked to the given audio player */
     DeckGUI(DJAudioPlayer* player,
-            juce::AudioFormatManager& formatManagerToUse,
-            juce::AudioThumbnailCache& cacheToUse);
+            juce::AudioFormatManager& formatManagerToUse);
     ~DeckGUI() override;
 
     /** Draw the deck background and panels */
@@ -34,7 +37,7 @@ public:
 
     /** Handle clicks on play, stop, load, hot cue and clear buttons */
     void buttonClicked(juce::Button*) override;
-    /** Handle changes to volume, speed, position and EQ sliders */
+    /** Handle changes to volume, speed, position, EQ and FX sliders */
     void sliderValueChanged(juce::Slider* slider) override;
 
     /** Return true if a single file is being dragged over the deck */
@@ -42,11 +45,24 @@ public:
     /** Load the dropped file into this deck */
     void filesDropped(const juce::StringArray& files, int x, int y) override;
 
-    /** Update waveform position and BPM label periodically */
+    /** Follow the deck's controls, loops and queued track, and the BPM label
+        when it changes */
     void timerCallback() override;
 
     /** Load an audio file into this deck, restoring its hot cues and EQ */
     void loadFile(juce::File file);
+    /** Prepare an audio file as this deck's next track, ready for LOAD NEXT */
+    void queueFile(juce::File file);
+    /** Check whether a next track is queued on this deck */
+    bool hasQueuedFile() const { return queuedTrackPath.isNotEmpty(); }
+
+    /** Returns the mixer sample of the next beat to lock to, or -1.
+        Set by the owner; used by PLAY and hot cues when QUANTISE is on. */
+    std::function<juce::int64()> getNextBeatSample;
+
+    /** Called when the PFL switch is flipped, to route the deck to the
+        headphone cue bus. Set by the owner. */
+    std::function<void(bool)> onCueToggled;
 
 private:
     // -------------------------
@@ -57,6 +73,7 @@ private:
     void updateHotCueButtonLabels();
     void loadHotCuesForCurrentTrack();
     void saveHotCuesForCurrentTrack();
+    void sendHotCuesToPlayer();
 
     juce::File getHotCuesFile();
     juce::var loadHotCuesJson();
@@ -68,6 +85,7 @@ private:
     void applyEQToPlayer();
     void loadEQForCurrentTrack();
     void saveEQForCurrentTrack();
+    void markEQChanged();
 
     juce::File getEQFile();
     juce::var loadEQJson();
@@ -78,6 +96,17 @@ private:
     // -------------------------
     void updateBpmLabel();
 
+    /** Move the playheads once per display frame, extrapolated from the
+        deck's last published block */
+    void updatePlayhead();
+
+    /** Move the controls to the deck's values, which a MIDI controller may
+        have changed without going through them */
+    void followPlayerControls();
+
+    /** Sample to schedule a quantised action at, or -1 to act immediately */
+    juce::int64 getQuantisedTarget() const;
+
 private:
     juce::FileChooser fChooser { "Select a file..." };
 
@@ -90,6 +119,13 @@ private:
     juce::Slider posSlider;
 
     WaveformDisplay waveformDisplay;
+    ScrollingWaveform scrollingWaveform;
+    SpectrumDisplay spectrumDisplay;
+    JogWheel jogWheel;
+
+    // Next track, prepared in the background
+    WaveformDisplay nextWaveform;
+    juce::TextButton loadNextButton { "LOAD NEXT" };
 
     // R4: EQ sliders (dB)
     juce::Slider lowEQSlider;
@@ -101,8 +137,22 @@ private:
     juce::Label midEQLabel;
     juce::Label highEQLabel;
 
+    // FX rack, one knob per effect
+    juce::Slider filterKnob;
+    juce::Slider flangerKnob;
+    juce::Slider echoKnob;
+    juce::Slider reverbKnob;
+    juce::Label filterLabel;
+    juce::Label flangerLabel;
+    juce::Label echoLabel;
+    juce::Label reverbLabel;
+
     // ✅ BPM label
     juce::Label bpmLabel;
+    juce::ToggleButton quantiseButton { "QUANTISE" };
+    juce::ToggleButton syncButton { "SYNC" };
+    juce::ToggleButton pflButton { "PFL" };
+    LevelMeter levelMeter;
 
     // R3 Hot Cues
     juce::ToggleButton cueModeButton { "CUE MODE" };
@@ -114,6 +164,15 @@ private:
 
     std::array<double, 8> hotCues; // relative positions (0.0 to 1.0). -1.0 = empty
 
+    // Loops and rolls
+    juce::TextButton loopInButton { "IN" };
+    juce::TextButton loopOutButton { "OUT" };
+    juce::TextButton beatLoopButton { "LOOP 4" };
+    juce::TextButton halveLoopButton { "1/2" };
+    juce::TextButton doubleLoopButton { "x2" };
+    juce::TextButton exitLoopButton { "EXIT" };
+    juce::ToggleButton slipButton { "SLIP" };
+
     // EQ values in dB (last adjusted)
     double lowDb  = 0.0;
     double midDb  = 0.0;
@@ -124,8 +183,19 @@ private:
     double originalMidDb  = 0.0;
     double originalHighDb = 0.0;
 
+    // EQ last sent to the player, so controller moves can be told apart from ours
+    double sentLowDb  = 0.0;
+    double sentMidDb  = 0.0;
+    double sentHighDb = 0.0;
+
+    // EQ changes are written to eq.json once they settle, not on every step
+    static constexpr juce::uint32 eqSaveDelayMs = 1000;
+    bool eqNeedsSaving = false;
+    juce::uint32 eqChangedAtMs = 0;
+
     DJAudioPlayer* player = nullptr;
     juce::String loadedTrackPath;
+    juce::String queuedTrackPath;
 
     // Theme colours
     const juce::Colour bgColour      { juce::Colour(30, 35, 40) };
@@ -135,6 +205,13 @@ private:
 
     bool lastIsPlaying = false;
 
+    // The BPM label as last written, so it is only rebuilt on a change
+    double shownBpm = -1.0;
+    bool shownSync = false;
+
+    double playheadSeconds = 0.0;
+    juce::VBlankAttachment vblankAttachment { this, [this] { updatePlayhead(); } };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckGUI)
 };
 
@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+    DurationProbe.cpp
+    Created: 19 Oct 2026 12:52:08am
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "DurationProbe.h"
+
+namespace
+{
+    // How far past the ID3v2 tag to look for the first frame
+    constexpr int searchBytes = 16 * 1024;
+
+    // kbps by [version 1, 2][layer I, II, III][index]
+    constexpr int bitrates[2][3][15] =
+    {
+        { { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },
+          { 0, 32, 48, 56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320, 384 },
+          { 0, 32, 40, 48,  56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320 } },
+        { { 0, 32, 48, 56,  64,  80,  96, 112, 128, 144, 160, 176, 192, 224, 256 },
+          { 0,  8, 16, 24,  32,  40,  48,  56,  64,  80,  96, 112, 128, 144, 160 },
+          { 0,  8, 16, 24,  32,  40,  48,  56,  64,  80,  96, 112, 128, 144, 160 } }
+    };
+
+    constexpr int sampleRates[3] = { 44100, 48000, 32000 };
+
+    uint32 readBigEndian(const uint8* p)
+    {
+        return ((uint32) p[0] << 24) | ((uint32) p[1] << 16) | ((uint32) p[2] << 8) | (uint32) p[3];
+    }
+
+    bool matches(const uint8* p, const char* tag)
+    {
+        return std::memcmp(p, tag, 4) == 0;
+    }
+}
+
+double DurationProbe::getDurationSec(const File& file, AudioFormatManager& formatManager)
+{
+    if (file.hasFileExtension("mp3"))
+    {
+        const double seconds = getMp3DurationSec(file);
+        if (seconds > 0.0)
+            return seconds;
+    }
+
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->sampleRate <= 0) return 0.0;
+
+    return (double) reader->lengthInSamples / reader->sampleRate;
+}
+
+double DurationProbe::getMp3DurationSec(const File& file)
+{
+    FileInputStream in(file);
+    if (in.failedToOpen())
+        return 0.0;
+
+    const int64 fileSize = in.getTotalLength();
+
+    // Skip an ID3v2 tag; its size is stored 7 bits to a byte
+    int64 audioStart = 0;
+    uint8 id3[10];
+
+    if (in.read(id3, 10) == 10 && id3[0] == 'I' && id3[1] == 'D' && id3[2] == '3')
+    {
+        audioStart = 10 + (((int64) (id3[6] & 0x7f) << 21) | ((id3[7] & 0x7f) << 14)
+                           | ((id3[8] & 0x7f) << 7) | (id3[9] & 0x7f));
+        if ((id3[5] & 0x10) != 0)
+            audioStart += 10;
+    }
+
+    HeapBlock<uint8> data(searchBytes);
+    in.setPosition(audioStart);
+    const int numRead = in.read(data, searchBytes);
+
+    for (int i = 0; i + 4 <= numRead; ++i)
+    {
+        const uint8* frame = data + i;
+
+        if (frame[0] != 0xff || (frame[1] & 0xe0) != 0xe0)
+            continue;
+
+        const int versionBits = (frame[1] >> 3) & 3;    // 0 = 2.5, 2 = 2, 3 = 1
+        const int layerBits = (frame[1] >> 1) & 3;      // 1 = III, 2 = II, 3 = I
+        const int bitrateIndex = frame[2] >> 4;
+        const int rateIndex = (frame[2] >> 2) & 3;
+
+        if (versionBits == 1 || layerBits == 0 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3)
+            continue;
+
+        const bool isVersion1 = versionBits == 3;
+        const int layer = 3 - layerBits;                // 0 = I, 1 = II, 2 = III
+        const int sampleRate = sampleRates[rateIndex] >> (isVersion1 ? 0 : versionBits == 2 ? 1 : 2);
+        const int samplesPerFrame = layer == 0 ? 384 : (layer == 1 || isVersion1) ? 1152 : 576;
+        const bool isMono = (frame[3] >> 6) == 3;
+        const int kbps = bitrates[isVersion1 ? 0 : 1][layer][bitrateIndex];
+        const int padding = (frame[2] >> 1) & 1;
+
+        // Stray 0xff bytes look like a sync too; a real frame is followed by another
+        const int frameBytes = layer == 0 ? (12 * kbps * 1000 / sampleRate + padding) * 4
+                                          : (layer == 2 && ! isVersion1 ? 72 : 144) * kbps * 1000 / sampleRate + padding;
+
+        if (i + frameBytes + 2 <= numRead
+            && (frame[frameBytes] != 0xff || (frame[frameBytes + 1] & 0xfe) != (frame[1] & 0xfe)))
+            continue;
+
+        // A VBR encoder leaves the frame count in the first frame
+        const int xingOffset = 4 + (isVersion1 ? (isMono ? 17 : 32) : (isMono ? 9 : 17));
+        const int vbriOffset = 4 + 32;
+        uint32 frames = 0;
+
+        if (i + xingOffset + 12 <= numRead
+            && (matches(frame + xingOffset, "Xing") || matches(frame + xingOffset, "Info"))
+            && (readBigEndian(frame + xingOffset + 4) & 1) != 0)
+        {
+            frames = readBigEndian(frame + xingOffset + 8);
+        }
+        else if (i + vbriOffset + 18 <= numRead && matches(frame + vbriOffset, "VBRI"))
+        {
+            frames = readBigEndian(frame + vbriOffset + 14);
+        }
+
+        if (frames > 0)
+            return (double) frames * samplesPerFrame / sampleRate;
+
+        // Constant bitrate: the audio is the file less the tags
+        int64 audioBytes = fileSize - (audioStart + i);
+
+        uint8 id3v1[3];
+        if (fileSize >= 128 && in.setPosition(fileSize - 128) && in.read(id3v1, 3) == 3
+            && id3v1[0] == 'T' && id3v1[1] == 'A' && id3v1[2] == 'G')
+            audioBytes -= 128;
+
+        return jmax(0.0, (double) audioBytes * 8.0 / (kbps * 1000.0));
+    }
+
+    return 0.0;
+}
@@ -0,0 +1,30 @@
+/*
+  ==============================================================================
+
+    DurationProbe.h
+    Created: 19 Oct 2026 12:52:08am
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/** Finds how long a track is from its headers, without decoding any audio.
+
+    An MP3 is read from its Xing/Info or VBRI header when it has one, and
+    otherwise from its first frame's bitrate and the size of the file.
+    Opening a reader for an MP3 can mean scanning every frame in it, which
+    is what makes a large import slow. Every other format is read through
+    the format manager, whose readers only parse the header.
+*/
+class DurationProbe
+{
+public:
+    /** Return the length of a track in seconds, or 0.0 if it can't be read */
+    static double getDurationSec(const File& file, AudioFormatManager& formatManager);
+
+    /** Return the length of an MP3 from its headers, or 0.0 if they don't say */
+    static double getMp3DurationSec(const File& file);
+};
@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    HotCueCache.cpp
+    Created: 18 Oct 2026 3:02:37pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "HotCueCache.h"
+
+HotCueCache::HotCueCache(TimeSliceThread& fillThread, double seconds)
+: thread(fillThread), secondsPerCue(seconds)
+{
+    thread.addTimeSliceClient(this);
+}
+
+HotCueCache::~HotCueCache()
+{
+    thread.removeTimeSliceClient(this);
+}
+
+void HotCueCache::setTrack(std::unique_ptr<AudioFormatReader> newReader)
+{
+    const ScopedLock sl(readerLock);
+
+    reader = std::move(newReader);
+
+    const int numChannels = reader != nullptr ? jlimit(1, 2, (int) reader->numChannels) : 1;
+    const int slotLength = reader != nullptr ? (int) std::ceil(reader->sampleRate * secondsPerCue) : 0;
+
+    // Preallocate every slot now so setting a cue never allocates
+    for (auto& slot : slots)
+    {
+        slot.requestedStart = -1;
+        slot.filledStart = -1;
+        slot.numFilled = 0;
+        slot.state = empty;
+        slot.audio.setSize(numChannels, slotLength);
+    }
+}
+
+void HotCueCache::setCue(int slot, int64 startSample)
+{
+    if (! isPositiveAndBelow(slot, numSlots)) return;
+
+    slots[(size_t) slot].requestedStart = jmax((int64) -1, startSample);
+    thread.moveToFrontOfQueue(this);
+}
+
+const AudioBuffer<float>* HotCueCache::acquire(int index, int64& startSample, int& numSamples)
+{
+    if (! isPositiveAndBelow(index, numSlots)) return nullptr;
+
+    auto& slot = slots[(size_t) index];
+    int expected = ready;
+
+    if (! slot.state.compare_exchange_strong(expected, playing, std::memory_order_acquire))
+        return nullptr;
+
+    // The cue moved since the slot was filled
+    if (slot.filledStart != slot.requestedStart.load() || slot.numFilled <= 0)
+    {
+        slot.state.store(ready, std::memory_order_release);
+        return nullptr;
+    }
+
+    startSample = slot.filledStart;
+    numSamples = slot.numFilled;
+    return &slot.audio;
+}
+
+void HotCueCache::release(int index)
+{
+    if (isPositiveAndBelow(index, numSlots))
+        slots[(size_t) index].state.store(ready, std::memory_order_release);
+}
+
+int HotCueCache::useTimeSlice()
+{
+    const ScopedLock sl(readerLock);
+
+    if (reader == nullptr) return 500;
+
+    for (auto& slot : slots)
+    {
+        const auto wanted = slot.requestedStart.load();
+        if (wanted == slot.filledStart) continue;
+
+        // Take the slot, unless the audio thread is playing out of it
+        int expected = ready;
+        if (! slot.state.compare_exchange_strong(expected, filling, std::memory_order_acquire))
+        {
+            expected = empty;
+            if (! slot.state.compare_exchange_strong(expected, filling, std::memory_order_acquire))
+                continue;
+        }
+
+        if (wanted < 0 || wanted >= reader->lengthInSamples)
+        {
+            slot.filledStart = wanted;
+            slot.numFilled = 0;
+            slot.state.store(empty, std::memory_order_release);
+            continue;
+        }
+
+        const int numSamples = (int) jmin((int64) slot.audio.getNumSamples(),
+                                          reader->lengthInSamples - wanted);
+
+        slot.audio.clear();
+        reader->read(&slot.audio, 0, numSamples, wanted, true, true);
+
+        slot.filledStart = wanted;
+        slot.numFilled = numSamples;
+        slot.state.store(ready, std::memory_order_release);
+
+        // One slot per slice, so the decks' read-ahead isn't held up
+        return 0;
+    }
+
+    return 100;
+}
@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    HotCueCache.h
+    Created: 18 Oct 2026 3:02:37pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+/** Keeps a couple of seconds of decoded audio after each hot cue in RAM.
+
+    The cue audio is decoded on a background thread, from a reader of its
+    own, whenever a cue is set or a track is loaded. When a cue is hit, the
+    audio thread claims the slot and plays straight out of it while the main
+    reader catches up in the background, so a jump never waits on the disk
+    or the decoder.
+*/
+class HotCueCache : private TimeSliceClient
+{
+public:
+    static constexpr int numSlots = 8;
+
+    HotCueCache(TimeSliceThread& fillThread, double secondsPerCue = 2.0);
+    ~HotCueCache() override;
+
+    /** Switch to a new track and drop every cue (message thread). The
+        reader is only ever used by the fill thread. No slot may be claimed
+        by the audio thread while this is called. */
+    void setTrack(std::unique_ptr<AudioFormatReader> reader);
+
+    /** Cache the audio starting at the given sample for a slot, or clear
+        the slot if startSample is negative (message thread) */
+    void setCue(int slot, int64 startSample);
+
+    /** Claim a slot for playback (audio thread). Returns nullptr if the slot
+        isn't filled yet or is out of date; otherwise fills in where the
+        cached audio starts and how many samples it holds. */
+    const AudioBuffer<float>* acquire(int slot, int64& startSample, int& numSamples);
+    /** Hand a claimed slot back (audio thread) */
+    void release(int slot);
+
+private:
+    int useTimeSlice() override;
+
+    enum SlotState { empty, ready, playing, filling };
+
+    struct Slot
+    {
+        AudioBuffer<float> audio;
+        std::atomic<int64> requestedStart { -1 };
+        std::atomic<int> state { empty };
+        int64 filledStart = -1;   // only written by the fill thread while it owns the slot
+        int numFilled = 0;
+    };
+
+    TimeSliceThread& thread;
+    const double secondsPerCue;
+
+    CriticalSection readerLock;
+    std::unique_ptr<AudioFormatReader> reader;
+    std::array<Slot, numSlots> slots;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HotCueCache)
+};
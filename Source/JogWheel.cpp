@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    JogWheel.cpp
+    Created: 18 Oct 2026 7:11:05pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "JogWheel.h"
+
+namespace
+{
+    // 33 1/3 rpm
+    constexpr double turnsPerSecond = 100.0 / 3.0 / 60.0;
+
+    // How much of each new drag reading is taken, to steady the mouse
+    constexpr double rateSmoothing = 0.5;
+}
+
+//==============================================================================
+JogWheel::JogWheel()
+{
+    setOpaque(false);
+    startTimerHz(60);
+}
+
+JogWheel::~JogWheel()
+{
+    stopTimer();
+}
+
+float JogWheel::getAngle(Point<float> p) const
+{
+    const auto centre = getLocalBounds().toFloat().getCentre();
+    return std::atan2(p.y - centre.y, p.x - centre.x);
+}
+
+void JogWheel::mouseDown(const MouseEvent& e)
+{
+    touched = true;
+    lastAngle = getAngle(e.position);
+    dragTurns = 0.0;
+    rate = sentRate = 0.0;
+    lastTickMs = Time::getMillisecondCounterHiRes();
+
+    if (onTouch) onTouch(true);
+    repaint();
+}
+
+void JogWheel::mouseDrag(const MouseEvent& e)
+{
+    if (! touched) return;
+
+    const float angle = getAngle(e.position);
+    float delta = angle - lastAngle;
+
+    // Take the short way round across the +/- pi seam
+    if (delta > MathConstants<float>::pi)  delta -= MathConstants<float>::twoPi;
+    if (delta < -MathConstants<float>::pi) delta += MathConstants<float>::twoPi;
+
+    dragTurns += delta / MathConstants<float>::twoPi;
+    lastAngle = angle;
+}
+
+void JogWheel::mouseUp(const MouseEvent&)
+{
+    if (! touched) return;
+
+    touched = false;
+    if (onTouch) onTouch(false);
+    repaint();
+}
+
+void JogWheel::timerCallback()
+{
+    if (touched)
+    {
+        const double now = Time::getMillisecondCounterHiRes();
+        const double seconds = jmax(0.001, (now - lastTickMs) * 0.001);
+        lastTickMs = now;
+
+        const double measured = dragTurns / seconds / turnsPerSecond;
+        dragTurns = 0.0;
+        rate += (measured - rate) * rateSmoothing;
+
+        // Only send changes; a hand holding still settles on exactly 0
+        if (std::abs(rate) < 0.01) rate = 0.0;
+        if (std::abs(rate - sentRate) > 0.005 || (rate == 0.0 && sentRate != 0.0))
+        {
+            sentRate = rate;
+            if (onRateChange) onRateChange(rate);
+        }
+    }
+
+    if (getPositionSeconds)
+    {
+        const auto turns = getPositionSeconds() * turnsPerSecond;
+        const auto angle = (float) ((turns - std::floor(turns)) * MathConstants<double>::twoPi);
+
+        if (std::abs(angle - markerAngle) > 0.01f)
+        {
+            markerAngle = angle;
+            repaint();
+        }
+    }
+}
+
+void JogWheel::paint(Graphics& g)
+{
+    const auto bounds = getLocalBounds().toFloat().reduced(2.0f);
+    const float size = jmin(bounds.getWidth(), bounds.getHeight());
+    const auto platter = Rectangle<float>(size, size).withCentre(bounds.getCentre());
+    const auto label = platter.reduced(size * 0.3f);
+    const auto centre = platter.getCentre();
+
+    g.setColour(Colour(20, 22, 25));
+    g.fillEllipse(platter);
+
+    // Grooves
+    g.setColour(Colours::white.withAlpha(0.06f));
+    for (float r = size * 0.24f; r < size * 0.48f; r += 3.0f)
+        g.drawEllipse(Rectangle<float>(r * 2.0f, r * 2.0f).withCentre(centre), 1.0f);
+
+    g.setColour(touched ? Colour(0, 170, 255) : Colour(60, 65, 70));
+    g.drawEllipse(platter, touched ? 2.0f : 1.0f);
+
+    g.setColour(Colour(0, 170, 255).withAlpha(0.7f));
+    g.fillEllipse(label);
+
+    // Marker, at 12 o'clock at the start of the track
+    const auto tip = centre.getPointOnCircumference(size * 0.47f, markerAngle);
+    g.setColour(Colours::white.withAlpha(0.9f));
+    g.drawLine(Line<float>(centre, tip), 2.0f);
+}
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    JogWheel.h
+    Created: 18 Oct 2026 7:11:05pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/** A turntable platter for scratching with the mouse.
+
+    Pressing on the platter puts a hand on the record; dragging around the
+    centre turns it, and the speed of the drag is reported as a playback
+    rate where one turn in 1.8 seconds (33 1/3 rpm) is normal speed.
+    The marker on the label follows the deck's playhead.
+*/
+class JogWheel : public Component,
+                 private Timer
+{
+public:
+    JogWheel();
+    ~JogWheel() override;
+
+    /** Draw the platter, the label and the position marker */
+    void paint(Graphics& g) override;
+
+    void mouseDown(const MouseEvent& e) override;
+    void mouseDrag(const MouseEvent& e) override;
+    void mouseUp(const MouseEvent& e) override;
+
+    /** Called with true when the platter is grabbed and false when let go */
+    std::function<void(bool)> onTouch;
+    /** Called while the platter is held with the speed it is being turned at:
+        1 = normal, 0 = still, negative = backwards */
+    std::function<void(double)> onRateChange;
+    /** Returns the deck's playhead in seconds, to turn the marker */
+    std::function<double()> getPositionSeconds;
+
+private:
+    void timerCallback() override;
+    float getAngle(Point<float> p) const;
+
+    bool touched = false;
+    float lastAngle = 0.0f;
+    double dragTurns = 0.0;         // turns since the last timer tick
+    double lastTickMs = 0.0;
+    double rate = 0.0;
+    double sentRate = 0.0;
+    float markerAngle = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JogWheel)
+};
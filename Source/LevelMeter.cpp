@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    LevelMeter.cpp
+    Created: 18 Oct 2026 4:31:52pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "LevelMeter.h"
+
+namespace
+{
+    constexpr float floorDb = -60.0f;
+    constexpr float topDb = 6.0f;
+
+    float toProportion(float gain)
+    {
+        const float db = Decibels::gainToDecibels(gain, floorDb);
+        return jlimit(0.0f, 1.0f, (db - floorDb) / (topDb - floorDb));
+    }
+}
+
+//==============================================================================
+LevelMeter::LevelMeter(const LevelMeterSource& sourceToShow)
+    : source(sourceToShow)
+{
+    setOpaque(false);
+    startTimerHz(30);
+}
+
+LevelMeter::~LevelMeter()
+{
+    stopTimer();
+}
+
+void LevelMeter::timerCallback()
+{
+    const auto levels = source.getLevels();
+    const float reduction = getGainReductionDb != nullptr ? getGainReductionDb() : 0.0f;
+
+    // Skip the repaint while nothing is playing
+    if (std::memcmp(&levels, &shown, sizeof(levels)) == 0 && reduction == shownReduction)
+        return;
+
+    shown = levels;
+    shownReduction = reduction;
+    repaint();
+}
+
+void LevelMeter::paint(Graphics& g)
+{
+    auto area = getLocalBounds().toFloat();
+    g.setFont(FontOptions(jmin(12.0f, area.getHeight())));
+
+    // Gain reduction readout
+    if (getGainReductionDb != nullptr)
+    {
+        auto text = area.removeFromRight(56.0f);
+        g.setColour(shownReduction > 0.1f ? Colour(0xffffb020) : Colours::white.withAlpha(0.45f));
+        g.drawText("GR " + String(-shownReduction, 1), text, Justification::centred);
+    }
+
+    // Short-term loudness readout
+    {
+        auto text = area.removeFromRight(64.0f);
+        const bool silent = shown.shortTermLufs <= LevelMeterSource::silenceLufs;
+        g.setColour(Colours::white.withAlpha(silent ? 0.45f : 0.85f));
+        g.drawText((silent ? String("-inf") : String(shown.shortTermLufs, 1)) + " LUFS",
+                   text, Justification::centred);
+    }
+
+    g.setColour(Colours::black.withAlpha(0.35f));
+    g.fillRoundedRectangle(area, 3.0f);
+
+    auto bars = area.reduced(2.0f);
+    const float zeroX = bars.getX() + bars.getWidth() * toProportion(1.0f);
+    const float barH = (bars.getHeight() - 2.0f) / 2.0f;
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        auto bar = bars.removeFromTop(barH);
+        bars.removeFromTop(2.0f);
+
+        const float rmsW = bar.getWidth() * toProportion(shown.rms[ch]);
+        const float peakX = bar.getX() + bar.getWidth() * toProportion(shown.peak[ch]);
+
+        g.setColour(Colour(0xff22c55e).withAlpha(0.85f));
+        g.fillRect(bar.withWidth(rmsW));
+
+        g.setColour(shown.peak[ch] >= 1.0f ? Colour(0xffef4444) : Colours::white.withAlpha(0.85f));
+        g.fillRect(jmax(bar.getX(), peakX - 2.0f), bar.getY(), 2.0f, bar.getHeight());
+    }
+
+    // 0 dBFS mark
+    g.setColour(Colour(0xffef4444).withAlpha(0.6f));
+    g.drawVerticalLine(roundToInt(zeroX), area.getY(), area.getBottom());
+}
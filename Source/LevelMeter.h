@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    LevelMeter.h
+    Created: 18 Oct 2026 4:31:52pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "LevelMeterSource.h"
+
+//==============================================================================
+/** A stereo peak/RMS bar meter with a short-term loudness readout that
+    polls a LevelMeterSource.
+
+    The bars run from left (-60 dB) to right (+6 dB): the solid part is the
+    RMS level and the thin line the held peak.
+*/
+class LevelMeter : public Component,
+                   private Timer
+{
+public:
+    /** Create a meter reading the given source, which must outlive it */
+    explicit LevelMeter(const LevelMeterSource& sourceToShow);
+    ~LevelMeter() override;
+
+    /** Draw both channel bars and the loudness and gain reduction readouts */
+    void paint(Graphics& g) override;
+
+    /** Optional gain reduction readout, in dB, drawn at the right-hand end */
+    std::function<float()> getGainReductionDb;
+
+private:
+    void timerCallback() override;
+
+    const LevelMeterSource& source;
+    LevelMeterSource::Levels shown;
+    float shownReduction = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeter)
+};
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    LevelMeterSource.cpp
+    Created: 18 Oct 2026 4:12:06pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "LevelMeterSource.h"
+
+namespace
+{
+    constexpr double rmsWindowSeconds = 0.3;
+    constexpr double peakFallDbPerSecond = 20.0;
+    constexpr double loudnessStepSeconds = 0.1;
+}
+
+void LevelMeterSource::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    current = {};
+    meanSquare[0] = meanSquare[1] = 0.0f;
+
+    // K-weighting for any sample rate: the BS.1770 pre-filter (a high shelf
+    // modelling the head) followed by the RLB high-pass
+    {
+        const double K = std::tan(MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+        const double Q = 0.7071752369554196;
+        const double Vh = std::pow(10.0, 3.999843853973347 / 20.0);
+        const double Vb = std::pow(Vh, 0.4996667741545416);
+        const double a0 = 1.0 + K / Q + K * K;
+
+        shelf = {};
+        shelf.b0 = (Vh + Vb * K / Q + K * K) / a0;
+        shelf.b1 = 2.0 * (K * K - Vh) / a0;
+        shelf.b2 = (Vh - Vb * K / Q + K * K) / a0;
+        shelf.a1 = 2.0 * (K * K - 1.0) / a0;
+        shelf.a2 = (1.0 - K / Q + K * K) / a0;
+    }
+
+    {
+        const double K = std::tan(MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+        const double Q = 0.5003270373238773;
+        const double a0 = 1.0 + K / Q + K * K;
+
+        highPass = {};
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (K * K - 1.0) / a0;
+        highPass.a2 = (1.0 - K / Q + K * K) / a0;
+    }
+
+    binEnergy.fill(0.0);
+    binAccumulator = 0.0;
+    binLength = jmax(1, roundToInt(sampleRate * loudnessStepSeconds));
+    binFill = binPos = binsFilled = 0;
+
+    levels.publish(current);
+}
+
+void LevelMeterSource::measure(const AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (numSamples <= 0 || sampleRate <= 0.0) return;
+
+    const double seconds = (double) numSamples / sampleRate;
+    const float fall = Decibels::decibelsToGain((float) (-peakFallDbPerSecond * seconds));
+    const float smoothing = (float) std::exp(-seconds / rmsWindowSeconds);
+
+    if (buffer.getNumChannels() <= 0) return;
+
+    // A mono signal is metered as if it were played on both sides
+    const float* channels[2];
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const int source = jmin(ch, buffer.getNumChannels() - 1);
+        channels[ch] = buffer.getReadPointer(source, startSample);
+
+        const float peak = buffer.getMagnitude(source, startSample, numSamples);
+        const float rms = buffer.getRMSLevel(source, startSample, numSamples);
+
+        current.peak[ch] = jmax(peak, current.peak[ch] * fall);
+
+        meanSquare[ch] = smoothing * meanSquare[ch] + (1.0f - smoothing) * rms * rms;
+        current.rms[ch] = std::sqrt(meanSquare[ch]);
+    }
+
+    measureLoudness(channels, numSamples);
+
+    levels.publish(current);
+}
+
+void LevelMeterSource::measureLoudness(const float* const* channels, int numSamples)
+{
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        // Work up to the end of the current 100 ms step
+        const int count = jmin(numSamples - done, binLength - binFill);
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            const float* x = channels[ch] + done;
+            double s1a = shelf.s1[ch], s2a = shelf.s2[ch];
+            double s1b = highPass.s1[ch], s2b = highPass.s2[ch];
+            double energy = 0.0;
+
+            for (int i = 0; i < count; ++i)
+            {
+                const double in = x[i];
+
+                const double mid = shelf.b0 * in + s1a;
+                s1a = shelf.b1 * in - shelf.a1 * mid + s2a;
+                s2a = shelf.b2 * in - shelf.a2 * mid;
+
+                const double out = highPass.b0 * mid + s1b;
+                s1b = highPass.b1 * mid - highPass.a1 * out + s2b;
+                s2b = highPass.b2 * mid - highPass.a2 * out;
+
+                energy += out * out;
+            }
+
+            shelf.s1[ch] = s1a;  shelf.s2[ch] = s2a;
+            highPass.s1[ch] = s1b;  highPass.s2[ch] = s2b;
+            binAccumulator += energy;
+        }
+
+        done += count;
+        binFill += count;
+
+        if (binFill < binLength) break;
+
+        // Step complete: slide the 3 s window along by one bin
+        binEnergy[(size_t) binPos] = binAccumulator;
+        binPos = (binPos + 1) % loudnessBins;
+        binsFilled = jmin(loudnessBins, binsFilled + 1);
+        binAccumulator = 0.0;
+        binFill = 0;
+
+        double windowEnergy = 0.0;
+        for (auto e : binEnergy)
+            windowEnergy += e;
+
+        const double meanPower = windowEnergy / ((double) binsFilled * binLength);
+        current.shortTermLufs = meanPower > 0.0
+                              ? jmax(silenceLufs, (float) (-0.691 + 10.0 * std::log10(meanPower)))
+                              : silenceLufs;
+    }
+}
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    LevelMeterSource.h
+    Created: 18 Oct 2026 4:12:06pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "SeqLockSnapshot.h"
+
+/** Measures peak, RMS and short-term loudness of a stereo signal on the
+    audio thread and publishes them for the GUI without locks.
+
+    Peaks are held and fall back at a fixed rate on the audio thread, so a
+    GUI polling at any rate still sees every overload. Loudness follows
+    ITU-R BS.1770: the signal is K-weighted and its power averaged over the
+    last 3 seconds, in 100 ms steps.
+*/
+class LevelMeterSource
+{
+public:
+    struct Levels
+    {
+        float peak[2] = { 0.0f, 0.0f };   // linear, with a falling hold
+        float rms[2]  = { 0.0f, 0.0f };   // linear, ~300 ms window
+        float shortTermLufs = silenceLufs;  // K-weighted, 3 s window
+    };
+
+    static constexpr float silenceLufs = -100.0f;
+
+    /** Reset the meter for a new sample rate (not while measuring) */
+    void prepare(double sampleRate);
+
+    /** Measure a block (audio thread) */
+    void measure(const AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /** Read the latest levels (any thread) */
+    Levels getLevels() const { return levels.read(); }
+
+private:
+    void measureLoudness(const float* const* channels, int numSamples);
+
+    /** One K-weighting biquad, transposed direct form II */
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double s1[2] = { 0.0, 0.0 }, s2[2] = { 0.0, 0.0 };
+    };
+
+    static constexpr int loudnessBins = 30;   // 30 x 100 ms
+
+    double sampleRate = 44100.0;
+    Levels current;
+    float meanSquare[2] = { 0.0f, 0.0f };
+
+    Biquad shelf, highPass;
+    std::array<double, loudnessBins> binEnergy {};
+    double binAccumulator = 0.0;
+    int binLength = 4410, binFill = 0, binPos = 0, binsFilled = 0;
+
+    SeqLockSnapshot<Levels> levels;
+};
@@ -0,0 +1,376 @@
+/*
+  ==============================================================================
+
+    LibraryStore.cpp
+    Created: 19 Oct 2026 12:14:52am
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "LibraryStore.h"
+
+namespace
+{
+    constexpr uint32 snapshotMagic = ByteOrder::makeInt('O', 'T', 'L', 'S');
+    constexpr uint32 journalMagic = ByteOrder::makeInt('O', 'T', 'L', 'J');
+    constexpr int fileVersion = 1;
+
+    constexpr int snapshotHeaderBytes = 4 * 4;
+    constexpr int journalHeaderBytes = 2 * 4;
+    constexpr int recordHeaderBytes = 2 * 4;
+
+    // The journal is compacted once it holds more records than this, or
+    // more than a quarter of the library, whichever is larger
+    constexpr int minCompactRecords = 1024;
+
+    // Anything bigger is a corrupt size field, not a track
+    constexpr int maxRecordBytes = 64 * 1024;
+
+    /** 32-bit FNV-1a */
+    uint32 checksum(const void* data, size_t numBytes)
+    {
+        const auto* bytes = static_cast<const uint8*>(data);
+        uint32 hash = 0x811c9dc5u;
+
+        for (size_t i = 0; i < numBytes; ++i)
+            hash = (hash ^ bytes[i]) * 0x01000193u;
+
+        return hash;
+    }
+}
+
+//==============================================================================
+LibraryStore::LibraryStore()
+    : LibraryStore(File::getSpecialLocation(File::userApplicationDataDirectory)
+                       .getChildFile("Otodecks"))
+{
+}
+
+LibraryStore::LibraryStore(const File& directory)
+    : snapshotFile(directory.getChildFile("library.snapshot")),
+      journalFile(directory.getChildFile("library.journal")),
+      jsonFile(directory.getChildFile("library.json"))
+{
+    directory.createDirectory();
+}
+
+LibraryStore::~LibraryStore()
+{
+    if (journal != nullptr)
+        journal->flush();
+}
+
+void LibraryStore::open()
+{
+    journal.reset();
+    tracks.clear();
+    journalRecords = 0;
+    readOnly = false;
+
+    if (snapshotFile.existsAsFile())
+    {
+        // Replaying the journal onto nothing would cut it short, and the
+        // next compaction would write the empty library over the snapshot
+        if (! readSnapshot())
+        {
+            DBG("LibraryStore: can't read " << snapshotFile.getFullPathName() << ", leaving it and the journal alone");
+            tracks.clear();
+            readOnly = true;
+            return;
+        }
+    }
+    else if (importJson())
+    {
+        // First run after library.json. Anything journalled since an earlier
+        // import whose snapshot failed is replayed on top, and once a snapshot
+        // holds it all the JSON is set aside so it is never imported again.
+        replayJournal();
+
+        if (compact())
+            jsonFile.moveFileTo(jsonFile.getSiblingFile(jsonFile.getFileName() + ".imported"));
+
+        return;
+    }
+
+    replayJournal();
+
+    if (journalRecords > jmax(minCompactRecords, getNumTracks() / 4))
+        compact();
+}
+
+int LibraryStore::add(const Track& track)
+{
+    return addAll({ track });
+}
+
+int LibraryStore::addAll(const std::vector<Track>& newTracks)
+{
+    const int first = getNumTracks();
+    if (newTracks.empty()) return first;
+
+    MemoryOutputStream records;
+    for (const auto& track : newTracks)
+        put(records, getNumTracks(), track);
+
+    writeRecords(records, (int) newTracks.size());
+    return first;
+}
+
+void LibraryStore::update(int row, const Track& track)
+{
+    updateAll({ { row, track } });
+}
+
+void LibraryStore::updateAll(const std::vector<std::pair<int, Track>>& changes)
+{
+    MemoryOutputStream records;
+    int numRecords = 0;
+
+    for (const auto& [row, track] : changes)
+    {
+        if (! isPositiveAndBelow(row, getNumTracks())) continue;
+
+        put(records, row, track);
+        ++numRecords;
+    }
+
+    if (numRecords > 0)
+        writeRecords(records, numRecords);
+}
+
+void LibraryStore::put(MemoryOutputStream& records, int row, const Track& track)
+{
+    if (row == getNumTracks())
+        tracks.push_back(track);
+    else
+        tracks[(size_t) row] = track;
+
+    MemoryOutputStream payload;
+    payload.writeInt(row);
+    writeTrack(payload, track);
+
+    records.writeInt((int) payload.getDataSize());
+    records.writeInt((int) checksum(payload.getData(), payload.getDataSize()));
+    records << payload;
+}
+
+bool LibraryStore::writeRecords(const MemoryOutputStream& records, int numRecords)
+{
+    if (readOnly || (journal == nullptr && ! startJournal()))
+        return false;
+
+    // One write and one flush (an fsync) per batch; a crash can only tear
+    // the last record, and replay stops there
+    journal->write(records.getData(), records.getDataSize());
+    journal->flush();
+
+    if (journal->getStatus().failed())
+        return false;
+
+    journalRecords += numRecords;
+    if (journalRecords > jmax(minCompactRecords, getNumTracks() / 4))
+        compact();
+
+    return true;
+}
+
+bool LibraryStore::compact()
+{
+    if (readOnly)
+        return false;
+
+    MemoryOutputStream body;
+    for (const auto& track : tracks)
+        writeTrack(body, track);
+
+    // Written to a temporary file and moved over, so a crash never leaves half a snapshot
+    TemporaryFile temp(snapshotFile);
+
+    {
+        FileOutputStream out(temp.getFile());
+        if (out.failedToOpen())
+            return false;
+
+        out.writeInt((int) snapshotMagic);
+        out.writeInt(fileVersion);
+        out.writeInt(getNumTracks());
+        out.writeInt((int) checksum(body.getData(), body.getDataSize()));
+        out << body;
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    if (! temp.overwriteTargetFileWithTemporary())
+        return false;
+
+    // Records still in the journal after a crash here are already in the
+    // snapshot, and replaying them changes nothing
+    journal.reset();
+    journalFile.deleteFile();
+    journalRecords = 0;
+    return startJournal();
+}
+
+//==============================================================================
+bool LibraryStore::readSnapshot()
+{
+    MemoryBlock data;
+    if (! snapshotFile.loadFileAsData(data) || data.getSize() < (size_t) snapshotHeaderBytes)
+        return false;
+
+    const auto* header = static_cast<const char*>(data.getData());
+    const int count = (int) ByteOrder::littleEndianInt(header + 8);
+    const auto* body = header + snapshotHeaderBytes;
+    const size_t bodySize = data.getSize() - (size_t) snapshotHeaderBytes;
+
+    if (ByteOrder::littleEndianInt(header) != snapshotMagic
+        || (int) ByteOrder::littleEndianInt(header + 4) != fileVersion
+        || count < 0
+        || ByteOrder::littleEndianInt(header + 12) != checksum(body, bodySize))
+        return false;
+
+    MemoryInputStream in(body, bodySize, false);
+    tracks.resize((size_t) count);
+
+    for (auto& track : tracks)
+        if (! readTrack(in, track))
+            return false;
+
+    return true;
+}
+
+bool LibraryStore::importJson()
+{
+    if (! jsonFile.existsAsFile())
+        return false;
+
+    auto parsed = JSON::parse(jsonFile.loadFileAsString());
+    auto* arr = parsed.getArray();
+    if (arr == nullptr) return false;
+
+    for (auto& item : *arr)
+    {
+        auto* obj = item.getDynamicObject();
+        if (obj == nullptr) continue;
+
+        Track t;
+        t.filePath = obj->getProperty("filePath").toString();
+        t.fileName = obj->getProperty("fileName").toString();
+        t.durationSec = (double) obj->getProperty("durationSec");
+        t.hasPreview = t.preview.fromBase64(obj->getProperty("preview").toString());
+
+        tracks.push_back(t);
+    }
+
+    return true;
+}
+
+void LibraryStore::replayJournal()
+{
+    MemoryBlock data;
+    journalFile.loadFileAsData(data);
+
+    const auto* bytes = static_cast<const char*>(data.getData());
+    size_t goodEnd = 0;
+
+    if (data.getSize() >= (size_t) journalHeaderBytes
+        && ByteOrder::littleEndianInt(bytes) == journalMagic
+        && (int) ByteOrder::littleEndianInt(bytes + 4) == fileVersion)
+    {
+        goodEnd = (size_t) journalHeaderBytes;
+
+        // Stop at the first record that is short, corrupt or out of order
+        while (goodEnd + (size_t) recordHeaderBytes <= data.getSize())
+        {
+            const int size = (int) ByteOrder::littleEndianInt(bytes + goodEnd);
+            const uint32 sum = ByteOrder::littleEndianInt(bytes + goodEnd + 4);
+            const auto* payload = bytes + goodEnd + recordHeaderBytes;
+
+            if (! isPositiveAndBelow(size, maxRecordBytes)
+                || goodEnd + (size_t) recordHeaderBytes + (size_t) size > data.getSize()
+                || checksum(payload, (size_t) size) != sum)
+                break;
+
+            MemoryInputStream in(payload, (size_t) size, false);
+            const int row = in.readInt();
+            Track track;
+
+            if (! isPositiveAndNotGreaterThan(row, getNumTracks()) || ! readTrack(in, track))
+                break;
+
+            if (row == getNumTracks())
+                tracks.push_back(std::move(track));
+            else
+                tracks[(size_t) row] = std::move(track);
+
+            goodEnd += (size_t) recordHeaderBytes + (size_t) size;
+            ++journalRecords;
+        }
+    }
+
+    if (goodEnd < data.getSize())
+    {
+        // Cut off the torn tail, or start again if even the header is bad
+        if (goodEnd == 0)
+            journalFile.deleteFile();
+        else
+            journalFile.replaceWithData(data.getData(), goodEnd);
+    }
+
+    startJournal();
+}
+
+bool LibraryStore::startJournal()
+{
+    const bool isNew = ! journalFile.existsAsFile() || journalFile.getSize() == 0;
+
+    journal = std::make_unique<FileOutputStream>(journalFile);
+    if (journal->failedToOpen())
+    {
+        journal.reset();
+        return false;
+    }
+
+    if (isNew)
+    {
+        journal->writeInt((int) journalMagic);
+        journal->writeInt(fileVersion);
+        journal->flush();
+    }
+
+    return true;
+}
+
+//==============================================================================
+void LibraryStore::writeTrack(OutputStream& out, const Track& track)
+{
+    out.writeString(track.filePath);
+    out.writeString(track.fileName);
+    out.writeDouble(track.durationSec);
+    out.writeBool(track.hasPreview);
+
+    if (track.hasPreview)
+    {
+        out.write(track.preview.peaks.data(), (size_t) TrackPreview::numColumns);
+        out.write(track.preview.rms.data(), (size_t) TrackPreview::numColumns);
+    }
+}
+
+bool LibraryStore::readTrack(InputStream& in, Track& track)
+{
+    track.filePath = in.readString();
+    track.fileName = in.readString();
+    track.durationSec = in.readDouble();
+    track.hasPreview = in.readBool();
+
+    if (track.hasPreview
+        && (in.read(track.preview.peaks.data(), TrackPreview::numColumns) != TrackPreview::numColumns
+            || in.read(track.preview.rms.data(), TrackPreview::numColumns) != TrackPreview::numColumns))
+        return false;
+
+    // Records and snapshots are checksummed, so this only catches a bad writer
+    return track.filePath.isNotEmpty();
+}
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    LibraryStore.h
+    Created: 19 Oct 2026 12:14:52am
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <utility>
+#include <vector>
+#include "TrackPreview.h"
+
+/** The track library, kept on disk as a binary snapshot plus a journal.
+
+    Adding or changing a track appends one small checksummed record to the
+    journal, so the cost of a change doesn't grow with the library. Once the
+    journal holds more records than it is worth replaying, the whole library
+    is written to a new snapshot and the journal is emptied.
+
+    Every record says which row it puts, so replaying one that is already in
+    the snapshot changes nothing. Snapshots are written to a temporary file
+    and renamed over the old one, and a record torn by a crash fails its
+    checksum and is cut off with everything after it, so whatever happens
+    the library opens as it was after some complete change.
+
+    A library.json left by an older version is imported the first time and
+    then renamed to library.json.imported. If the snapshot is there but can't
+    be read, neither it nor the journal is touched: the library opens empty
+    and changes are kept in memory only, until the files are sorted out.
+*/
+class LibraryStore
+{
+public:
+    struct Track
+    {
+        String filePath;
+        String fileName;
+        double durationSec = 0.0;
+        TrackPreview preview;
+        bool hasPreview = false;
+    };
+
+    /** Create a store in the Otodecks app-data directory */
+    LibraryStore();
+    explicit LibraryStore(const File& directory);
+    ~LibraryStore();
+
+    /** Read the snapshot and replay the journal, replacing any tracks held */
+    void open();
+
+    int getNumTracks() const { return (int) tracks.size(); }
+    const Track& getTrack(int row) const { return tracks[(size_t) row]; }
+
+    /** Add a track at the end of the library and return its row */
+    int add(const Track& track);
+    /** Add tracks at the end of the library with one journal write, and
+        return the row of the first */
+    int addAll(const std::vector<Track>& newTracks);
+    /** Replace the track in a row */
+    void update(int row, const Track& track);
+    /** Replace the tracks in several rows with one journal write. Rows that
+        don't exist are skipped. */
+    void updateAll(const std::vector<std::pair<int, Track>>& changes);
+
+    /** Write a new snapshot and empty the journal. Returns false if the
+        snapshot couldn't be written, in which case the journal is kept. */
+    bool compact();
+
+private:
+    void put(MemoryOutputStream& records, int row, const Track& track);
+    bool writeRecords(const MemoryOutputStream& records, int numRecords);
+    bool readSnapshot();
+    bool importJson();
+    void replayJournal();
+    bool startJournal();
+
+    static void writeTrack(OutputStream& out, const Track& track);
+    static bool readTrack(InputStream& in, Track& track);
+
+    const File snapshotFile;
+    const File journalFile;
+    const File jsonFile;
+
+    std::vector<Track> tracks;
+    std::unique_ptr<FileOutputStream> journal;
+    int journalRecords = 0;
+    bool readOnly = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibraryStore)
+};
@@ -9,6 +9,8 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "MainComponent.h"
+#include "OfflineMixRenderer.h"
+#include <iostream>
 
 //==============================================================================
 class OtoDecksApplication  : public JUCEApplication
@@ -25,9 +27,61 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
+        // Headless export: OtoDecks --render <mixlog.json> <output.wav> [blockSize]
+        auto args = StringArray::fromTokens (commandLine, true);
+        const int renderIndex = args.indexOf ("--render");
+
+        if (renderIndex >= 0)
+        {
+            setApplicationReturnValue (renderFromCommandLine (args, renderIndex) ? 0 : 1);
+            quit();
+            return;
+        }
+
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
 
+    bool renderFromCommandLine (const StringArray& args, int renderIndex)
+    {
+        if (args.size() < renderIndex + 3)
+        {
+            std::cerr << "Usage: OtoDecks --render <mixlog.json> <output.wav> [blockSize]" << std::endl;
+            return false;
+        }
+
+        auto cwd = File::getCurrentWorkingDirectory();
+        auto logFile = cwd.getChildFile (args[renderIndex + 1].unquoted());
+        auto outFile = cwd.getChildFile (args[renderIndex + 2].unquoted());
+        const int blockSize = args.size() > renderIndex + 3 ? args[renderIndex + 3].getIntValue() : 512;
+
+        ControlLog log;
+        if (! log.loadFromFile (logFile))
+        {
+            std::cerr << "Could not read control log " << logFile.getFullPathName() << std::endl;
+            return false;
+        }
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        OfflineMixRenderer renderer (formatManager);
+
+        const auto start = Time::getMillisecondCounterHiRes();
+        auto result = renderer.render (log, outFile, blockSize);
+        const auto elapsedSec = (Time::getMillisecondCounterHiRes() - start) / 1000.0;
+
+        if (result.failed())
+        {
+            std::cerr << result.getErrorMessage() << std::endl;
+            return false;
+        }
+
+        const double mixSec = (double) log.getLengthInSamples() / log.getSampleRate();
+        std::cout << "Rendered " << mixSec << " s of audio in " << elapsedSec << " s ("
+                  << (elapsedSec > 0.0 ? mixSec / elapsedSec : 0.0) << "x real time)" << std::endl;
+        return true;
+    }
+
     void shutdown() override
     {
         // Add your application's shutdown code here..
@@ -8,7 +8,50 @@
 */
 
 #include "MainComponent.h"
+#include "OfflineMixRenderer.h"
 
+//==============================================================================
+/** Renders a recorded control log to disk behind a progress window */
+class MixExportJob : public ThreadWithProgressWindow
+{
+public:
+    MixExportJob(AudioFormatManager& formatManager, const ControlLog& logToRender,
+                 File outputFile, std::function<void(Result)> onFinished)
+        : ThreadWithProgressWindow("Exporting mix...", true, true),
+          renderer(formatManager),
+          log(logToRender),
+          target(std::move(outputFile)),
+          finished(std::move(onFinished))
+    {
+    }
+
+    void run() override
+    {
+        result = renderer.render(log, target, 512, [this](double progress)
+        {
+            setProgress(progress);
+            return ! threadShouldExit();
+        });
+    }
+
+    void threadComplete(bool userPressedCancel) override
+    {
+        if (userPressedCancel && result.wasOk())
+            result = Result::fail("Render cancelled");
+
+        if (finished != nullptr)
+            finished(result);
+    }
+
+private:
+    OfflineMixRenderer renderer;
+    const ControlLog& log;
+    File target;
+    std::function<void(Result)> finished;
+    Result result = Result::ok();
+};
+
+//==============================================================================
 MainComponent::MainComponent()
 {
     setSize (800, 600);
@@ -17,49 +60,87 @@ MainComponent::MainComponent()
         && ! RuntimePermissions::isGranted (RuntimePermissions::recordAudio))
     {
         RuntimePermissions::request (RuntimePermissions::recordAudio,
-                                     [&] (bool granted) { if (granted)  setAudioChannels (2, 2); });
+                                     [&] (bool granted) { if (granted)  setAudioChannels (2, 4); });
     }
     else
     {
-        setAudioChannels (0, 2);
+        // Outputs 3 and 4 carry the headphone cue bus where the device has them
+        setAudioChannels (0, 4);
     }
 
     addAndMakeVisible(deckGUI1);
     addAndMakeVisible(deckGUI2);
     addAndMakeVisible(playlistComponent);
 
+    addAndMakeVisible(recordButton);
+    addAndMakeVisible(exportButton);
+    recordButton.setClickingTogglesState(true);
+    recordButton.setColour(TextButton::buttonOnColourId, Colour(0xffef4444).withAlpha(0.70f));
+    recordButton.addListener(this);
+    exportButton.addListener(this);
+
+    addAndMakeVisible(masterMeter);
+    addAndMakeVisible(masterSpectrum);
+    addAndMakeVisible(limiterButton);
+    masterMeter.getGainReductionDb = [this] { return mixer.getMasterBus().getGainReductionDb(); };
+    limiterButton.setClickingTogglesState(true);
+    limiterButton.setToggleState(mixer.getMasterBus().isLimiterEnabled(), dontSendNotification);
+    limiterButton.setColour(TextButton::buttonOnColourId, Colour(0xff22c55e).withAlpha(0.45f));
+    limiterButton.addListener(this);
+
+    addAndMakeVisible(reverbButton);
+    reverbButton.addListener(this);
+
+    addAndMakeVisible(midiButton);
+    midiButton.addListener(this);
+    midiController.onLearnt = [this](int, MidiController::Action) { updateMidiButton(); };
+
+    addAndMakeVisible(cueMixSlider);
+    cueMixSlider.setSliderStyle(Slider::LinearHorizontal);
+    cueMixSlider.setTextBoxStyle(Slider::NoTextBox, false, 0, 0);
+    cueMixSlider.setRange(0.0, 1.0, 0.01);
+    cueMixSlider.setValue(mixer.getCueMix(), dontSendNotification);
+    cueMixSlider.addListener(this);
+
+    addAndMakeVisible(cueMixLabel);
+    cueMixLabel.setText("CUE / MST", dontSendNotification);
+    cueMixLabel.setFont(FontOptions(11.0f));
+    cueMixLabel.setColour(Label::textColourId, Colours::white.withAlpha(0.85f));
+    cueMixLabel.setJustificationType(Justification::centredRight);
+
+    deckGUI1.onCueToggled = [this](bool on) { mixer.setCueEnabled(0, on); };
+    deckGUI2.onCueToggled = [this](bool on) { mixer.setCueEnabled(1, on); };
+
     playlistComponent.loadToDeck1 = [this](File file) { deckGUI1.loadFile(file); };
     playlistComponent.loadToDeck2 = [this](File file) { deckGUI2.loadFile(file); };
+    playlistComponent.queueTrack = [this](File file) { queueNextTrack(file); };
+
+    deckGUI1.getNextBeatSample = [this] { return mixer.getNextBeatSample(0); };
+    deckGUI2.getNextBeatSample = [this] { return mixer.getNextBeatSample(1); };
 
     formatManager.registerBasicFormats();
 }
 
 MainComponent::~MainComponent()
 {
+    exportJob.reset();
+    mixer.stopRecording();
     shutdownAudio();
 }
 
 void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
-    player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
-
-    mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
+    mixer.prepareToPlay(samplesPerBlockExpected, sampleRate);
 }
 
 void MainComponent::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
 {
-    mixerSource.getNextAudioBlock(bufferToFill);
+    mixer.getNextAudioBlock(bufferToFill);
 }
 
 void MainComponent::releaseResources()
 {
-    player1.releaseResources();
-    player2.releaseResources();
-    mixerSource.releaseResources();
+    mixer.releaseResources();
 }
 
 void MainComponent::paint (Graphics& g)
@@ -78,6 +159,29 @@ void MainComponent::resized()
 
     const int decksH = (int) std::round(area.getHeight() * decksRatio);
     auto decksArea = area.removeFromTop(decksH);
+
+    // Master meter and mix recording / export strip between the decks and the playlist
+    auto toolbar = area.removeFromTop(36).reduced(4);
+    exportButton.setBounds(toolbar.removeFromRight(130));
+    toolbar.removeFromRight(6);
+    recordButton.setBounds(toolbar.removeFromRight(110));
+
+    // Master meter on the left, taking whatever the buttons leave
+    const int buttonsW = 140 + 70 + 160 + 110 + 70 + 100 + 5 * 6;
+    masterMeter.setBounds(toolbar.removeFromLeft(jmax(120, toolbar.getWidth() - buttonsW - 6)));
+    toolbar.removeFromLeft(6);
+    masterSpectrum.setBounds(toolbar.removeFromLeft(140));
+    toolbar.removeFromLeft(6);
+    limiterButton.setBounds(toolbar.removeFromLeft(70));
+    toolbar.removeFromLeft(6);
+    reverbButton.setBounds(toolbar.removeFromLeft(160));
+    toolbar.removeFromLeft(6);
+    midiButton.setBounds(toolbar.removeFromLeft(110));
+    toolbar.removeFromLeft(6);
+    cueMixLabel.setBounds(toolbar.removeFromLeft(70));
+    toolbar.removeFromLeft(6);
+    cueMixSlider.setBounds(toolbar.removeFromLeft(100));
+
     auto playlistArea = area; // remaining
 
     // Two decks side-by-side in the decksArea
@@ -91,4 +195,192 @@ void MainComponent::resized()
     playlistComponent.setBounds(playlistArea.reduced(4));
 }
 
+void MainComponent::buttonClicked(Button* button)
+{
+    if (button == &limiterButton)
+    {
+        mixer.getMasterBus().setLimiterEnabled(limiterButton.getToggleState());
+        return;
+    }
+
+    if (button == &reverbButton)
+    {
+        auto flags = FileBrowserComponent::openMode | FileBrowserComponent::canSelectFiles;
 
+        reverbChooser.launchAsync(flags, [this](const FileChooser& chooser)
+        {
+            auto file = chooser.getResult();
+            if (! file.existsAsFile()) return;
+
+            mixer.loadReverbImpulse(file);
+            reverbButton.setButtonText("IR: " + file.getFileNameWithoutExtension());
+        });
+        return;
+    }
+
+    if (button == &midiButton)
+    {
+        showMidiMenu();
+        return;
+    }
+
+    if (button == &recordButton)
+    {
+        // The export thread reads the log, so don't start a new take under it
+        if (exportJob != nullptr)
+        {
+            recordButton.setToggleState(false, dontSendNotification);
+            return;
+        }
+
+        if (recordButton.getToggleState())
+            mixer.startRecording(recordedLog);
+        else
+            mixer.stopRecording();
+
+        return;
+    }
+
+    if (button == &exportButton)
+    {
+        if (mixer.isRecording())
+        {
+            mixer.stopRecording();
+            recordButton.setToggleState(false, dontSendNotification);
+        }
+
+        if (recordedLog.getLengthInSamples() <= 0)
+        {
+            AlertWindow::showMessageBoxAsync(MessageBoxIconType::InfoIcon, "Export mix",
+                                             "Record a mix with REC MIX first.");
+            return;
+        }
+
+        auto flags = FileBrowserComponent::saveMode
+                   | FileBrowserComponent::canSelectFiles
+                   | FileBrowserComponent::warnAboutOverwriting;
+
+        exportChooser.launchAsync(flags, [this](const FileChooser& chooser)
+        {
+            auto file = chooser.getResult();
+            if (file != File{})
+                exportRecordedMix(file.withFileExtension("wav"));
+        });
+    }
+}
+
+void MainComponent::sliderValueChanged(Slider* slider)
+{
+    if (slider == &cueMixSlider)
+        mixer.setCueMix((float) cueMixSlider.getValue());
+}
+
+void MainComponent::queueNextTrack(File file)
+{
+    // The next track goes to a deck that isn't on air, preferring one
+    // without a track queued already
+    const bool deck1Free = ! mixer.getDeck(0).isPlaying();
+    const bool deck2Free = ! mixer.getDeck(1).isPlaying();
+
+    DeckGUI* target = &deckGUI1;
+
+    if (deck1Free != deck2Free)
+        target = deck1Free ? &deckGUI1 : &deckGUI2;
+    else if (deckGUI1.hasQueuedFile() && ! deckGUI2.hasQueuedFile())
+        target = &deckGUI2;
+
+    target->queueFile(file);
+}
+
+void MainComponent::showMidiMenu()
+{
+    enum { noInput = 1, virtualInput, clearMappings, cancelLearning, firstDevice = 100, firstLearn = 1000 };
+
+    const auto devices = MidiInput::getAvailableDevices();
+    const auto openName = midiController.getInputName();
+
+    PopupMenu inputs;
+    for (int i = 0; i < devices.size(); ++i)
+        inputs.addItem(firstDevice + i, devices[i].name, true, devices[i].name == openName);
+
+    inputs.addSeparator();
+    inputs.addItem(virtualInput, "Virtual port \"OtoDecks\"", true, openName == "OtoDecks");
+    inputs.addItem(noInput, "None", openName.isNotEmpty());
+
+    PopupMenu menu;
+    menu.addSubMenu("Input", inputs);
+
+    // Pick a control, then move the knob or press the pad to bind to it
+    for (int deck = 0; deck < mixer.getNumDecks(); ++deck)
+    {
+        PopupMenu learn;
+        for (int a = 0; a < (int) MidiController::Action::numActions; ++a)
+            learn.addItem(firstLearn + deck * 100 + a, MidiController::getActionName((MidiController::Action) a));
+
+        menu.addSubMenu("Learn deck " + String(deck + 1), learn, openName.isNotEmpty());
+    }
+
+    menu.addSeparator();
+    menu.addItem(cancelLearning, "Cancel learning", midiController.isLearning());
+    menu.addItem(clearMappings, "Clear mappings");
+
+    menu.showMenuAsync(PopupMenu::Options().withTargetComponent(midiButton),
+        [safe = Component::SafePointer<MainComponent>(this), devices](int result)
+        {
+            if (safe == nullptr || result == 0) return;
+            auto& midi = safe->midiController;
+
+            if (result >= firstLearn)
+                midi.startLearning((result - firstLearn) / 100, (MidiController::Action) ((result - firstLearn) % 100));
+            else if (result >= firstDevice)
+                midi.openInput(devices[result - firstDevice].identifier);
+            else if (result == virtualInput)
+                midi.openVirtualInput("OtoDecks");
+            else if (result == noInput)
+                midi.closeInput();
+            else if (result == cancelLearning)
+                midi.cancelLearning();
+            else if (result == clearMappings)
+                midi.clearMappings();
+
+            safe->updateMidiButton();
+        });
+}
+
+void MainComponent::updateMidiButton()
+{
+    if (midiController.isLearning())
+        midiButton.setButtonText("MIDI: LEARN...");
+    else if (midiController.getInputName().isNotEmpty())
+        midiButton.setButtonText("MIDI: " + midiController.getInputName());
+    else
+        midiButton.setButtonText("MIDI");
+}
+
+void MainComponent::exportRecordedMix(File outputFile)
+{
+    if (exportJob != nullptr) return;
+
+    // Keep the control log next to the mix so the render can be reproduced
+    recordedLog.saveToFile(outputFile.withFileExtension("mixlog.json"));
+
+    exportJob = std::make_unique<MixExportJob>(formatManager, recordedLog, outputFile,
+        [safe = Component::SafePointer<MainComponent>(this), outputFile](Result result)
+        {
+            MessageManager::callAsync([safe, outputFile, result]
+            {
+                if (safe == nullptr) return;
+
+                safe->exportJob.reset();
+
+                if (result.wasOk())
+                    AlertWindow::showMessageBoxAsync(MessageBoxIconType::InfoIcon, "Export mix",
+                                                     "Mix written to " + outputFile.getFullPathName());
+                else
+                    AlertWindow::showMessageBoxAsync(MessageBoxIconType::WarningIcon, "Export mix",
+                                                     result.getErrorMessage());
+            });
+        });
+
+    exportJob->launchThread();
+}
@@ -11,11 +11,20 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "DJAudioPlayer.h"
+#include "DJMixer.h"
+#include "ControlLog.h"
 #include "DeckGUI.h"
 #include "PlaylistComponent.h"
+#include "LevelMeter.h"
+#include "SpectrumDisplay.h"
+#include "MidiController.h"
+
+class MixExportJob;
 
 //==============================================================================
-class MainComponent  : public AudioAppComponent
+class MainComponent  : public AudioAppComponent,
+                       public Button::Listener,
+                       public Slider::Listener
 {
 public:
     MainComponent();
@@ -33,19 +42,50 @@ public:
     /** Layout the two decks side-by-side with the playlist below */
     void resized() override;
 
+    /** Handle the record, export, limiter, reverb and MIDI buttons */
+    void buttonClicked(Button* button) override;
+    /** Handle the headphone cue/master blend */
+    void sliderValueChanged(Slider* slider) override;
+
 private:
+    void exportRecordedMix(File outputFile);
+    void queueNextTrack(File file);
+    void showMidiMenu();
+    void updateMidiButton();
+
     AudioFormatManager formatManager;
-    AudioThumbnailCache thumbCache { 100 };
 
-    DJAudioPlayer player1 { formatManager };
-    DeckGUI deckGUI1 { &player1, formatManager, thumbCache };
+    DJMixer mixer { formatManager, 2 };
 
-    DJAudioPlayer player2 { formatManager };
-    DeckGUI deckGUI2 { &player2, formatManager, thumbCache };
+    DeckGUI deckGUI1 { &mixer.getDeck(0), formatManager };
+    DeckGUI deckGUI2 { &mixer.getDeck(1), formatManager };
 
-    MixerAudioSource mixerSource;
     PlaylistComponent playlistComponent { formatManager };
 
+    // Offline mix export
+    ControlLog recordedLog;
+    TextButton recordButton { "REC MIX" };
+    TextButton exportButton { "EXPORT MIX" };
+    juce::FileChooser exportChooser { "Export mix as...", File{}, "*.wav" };
+    std::unique_ptr<MixExportJob> exportJob;
+
+    // Master output
+    LevelMeter masterMeter { mixer.getMasterBus().getMeter() };
+    SpectrumDisplay masterSpectrum { mixer.getMasterSpectrum() };
+    TextButton limiterButton { "LIMIT" };
+
+    // Send reverb
+    TextButton reverbButton { "REVERB IR..." };
+    juce::FileChooser reverbChooser { "Choose an impulse response...", File{}, "*.wav;*.aif;*.aiff;*.flac" };
+
+    // Hardware control, straight into the decks
+    MidiController midiController { mixer };
+    TextButton midiButton { "MIDI" };
+
+    // Headphones: cue bus on outputs 3/4, blended with the master
+    Slider cueMixSlider;
+    Label cueMixLabel;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
 
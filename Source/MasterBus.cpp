@@ -0,0 +1,235 @@
+/*
+  ==============================================================================
+
+    MasterBus.cpp
+    Created: 18 Oct 2026 4:05:41pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "MasterBus.h"
+
+namespace
+{
+    constexpr float gainReductionFallDbPerSecond = 30.0f;
+}
+
+void MasterBus::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    blockSize = jmax(1, maximumBlockSize);
+
+    lookahead = jmax(1, roundToInt(sampleRate * lookaheadSeconds));
+    // The gain for a sample comes out of the detector, the running minimum
+    // and the moving average this many samples after the sample went in
+    delaySamples = lookahead - 1 + detectorLatency;
+
+    // Hann-windowed sinc, centred between taps 3 and 4, one filter per fraction
+    for (int phase = 1; phase < oversampling; ++phase)
+    {
+        auto* c = phaseCoefficients[phase - 1];
+        const double fraction = (double) phase / oversampling;
+        double sum = 0.0;
+
+        for (int t = 0; t < tapsPerPhase; ++t)
+        {
+            const double x = (t - (detectorLatency - 1)) - fraction;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(MathConstants<double>::pi * x) / (MathConstants<double>::pi * x);
+            const double window = 0.5 * (1.0 + std::cos(MathConstants<double>::pi * x / detectorLatency));
+            c[t] = (float) (sinc * window);
+            sum += c[t];
+        }
+
+        for (int t = 0; t < tapsPerPhase; ++t)
+            c[t] = (float) (c[t] / sum);
+    }
+
+    delayLine.setSize(2, delaySamples + blockSize);
+    delayLine.clear();
+    delayWritePos = 0;
+
+    detectorInput.setSize(2, historyLength + blockSize);
+    detectorInput.clear();
+
+    truePeaks.assign((size_t) blockSize, 0.0f);
+    interpolated.assign((size_t) blockSize, 0.0f);
+    gains.assign((size_t) blockSize, 1.0f);
+
+    holdValues.assign((size_t) lookahead, 1.0f);
+    holdIndices.assign((size_t) lookahead, 0);
+    boxValues.assign((size_t) lookahead, 1.0f);
+    gainStateIsClear = false;
+    resetGainState();
+
+    gainReductionHold = 0.0f;
+    gainReductionDb = 0.0f;
+
+    meter.prepare(sampleRate);
+}
+
+void MasterBus::process(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (blockSize <= 0) return;
+
+    // Hosts may hand over more than they promised; work through it in pieces
+    while (numSamples > 0)
+    {
+        const int chunk = jmin(numSamples, blockSize);
+        processChunk(buffer, startSample, chunk);
+        startSample += chunk;
+        numSamples -= chunk;
+    }
+}
+
+void MasterBus::processChunk(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const int numChannels = jmin(2, buffer.getNumChannels());
+    if (numChannels <= 0) return;
+
+    const int ringLength = delayLine.getNumSamples();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const auto* in = buffer.getReadPointer(ch, startSample);
+
+        // Feed the detector and write into the delay line
+        FloatVectorOperations::copy(detectorInput.getWritePointer(ch, historyLength), in, numSamples);
+
+        const int first = jmin(numSamples, ringLength - delayWritePos);
+        FloatVectorOperations::copy(delayLine.getWritePointer(ch, delayWritePos), in, first);
+        FloatVectorOperations::copy(delayLine.getWritePointer(ch), in + first, numSamples - first);
+    }
+
+    if (limiterEnabled.load(std::memory_order_relaxed))
+    {
+        computeTruePeaks(numChannels, numSamples);
+        computeGains(numSamples);
+    }
+    else
+    {
+        resetGainState();
+        FloatVectorOperations::fill(gains.data(), 1.0f, numSamples);
+    }
+
+    // Read the delayed audio back out and apply the gain
+    const int readPos = (delayWritePos - delaySamples + ringLength) % ringLength;
+    const int first = jmin(numSamples, ringLength - readPos);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* out = buffer.getWritePointer(ch, startSample);
+
+        FloatVectorOperations::copy(out, delayLine.getReadPointer(ch, readPos), first);
+        FloatVectorOperations::copy(out + first, delayLine.getReadPointer(ch), numSamples - first);
+        FloatVectorOperations::multiply(out, gains.data(), numSamples);
+
+        // Keep the last few samples for the next block's interpolation
+        auto* history = detectorInput.getWritePointer(ch);
+        std::memmove(history, history + numSamples, sizeof(float) * (size_t) historyLength);
+    }
+
+    delayWritePos = (delayWritePos + numSamples) % ringLength;
+
+    const float minGain = FloatVectorOperations::findMinimum(gains.data(), numSamples);
+    const float seconds = (float) (numSamples / sampleRate);
+    gainReductionHold = jmax(-Decibels::gainToDecibels(minGain, -100.0f),
+                             gainReductionHold - gainReductionFallDbPerSecond * seconds);
+    gainReductionDb.store(jmax(0.0f, gainReductionHold), std::memory_order_relaxed);
+
+    meter.measure(buffer, startSample, numSamples);
+}
+
+void MasterBus::computeTruePeaks(int numChannels, int numSamples)
+{
+    auto* peaks = truePeaks.data();
+    auto* temp = interpolated.data();
+
+    FloatVectorOperations::clear(peaks, numSamples);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const auto* x = detectorInput.getReadPointer(ch);
+
+        // The sample itself...
+        FloatVectorOperations::abs(temp, x + detectorLatency - 1, numSamples);
+        FloatVectorOperations::max(peaks, peaks, temp, numSamples);
+
+        // ...and the three points between it and the next one
+        for (const auto& c : phaseCoefficients)
+        {
+            FloatVectorOperations::multiply(temp, x, c[0], numSamples);
+
+            for (int t = 1; t < tapsPerPhase; ++t)
+                FloatVectorOperations::addWithMultiply(temp, x + t, c[t], numSamples);
+
+            FloatVectorOperations::abs(temp, temp, numSamples);
+            FloatVectorOperations::max(peaks, peaks, temp, numSamples);
+        }
+    }
+}
+
+void MasterBus::computeGains(int numSamples)
+{
+    const float ceiling = ceilingGain.load(std::memory_order_relaxed);
+    const float release = (float) std::exp(-1.0 / (0.001 * releaseMs.load(std::memory_order_relaxed) * sampleRate));
+    const int capacity = lookahead;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float peak = truePeaks[(size_t) i];
+        const float required = peak > ceiling ? ceiling / peak : 1.0f;
+
+        // Instant attack, exponential release
+        envelope = required < envelope ? required : required + (envelope - required) * release;
+
+        // Running minimum over the look-ahead, so the gain is fully down
+        // for the whole window before the peak leaves the delay line
+        const int64 oldest = detectorCount - lookahead;
+        if (holdSize > 0 && holdIndices[(size_t) holdFront] <= oldest)
+        {
+            holdFront = (holdFront + 1) % capacity;
+            --holdSize;
+        }
+
+        while (holdSize > 0)
+        {
+            const int back = (holdFront + holdSize - 1) % capacity;
+            if (holdValues[(size_t) back] < envelope) break;
+            --holdSize;
+        }
+
+        const int slot = (holdFront + holdSize) % capacity;
+        holdValues[(size_t) slot] = envelope;
+        holdIndices[(size_t) slot] = detectorCount;
+        ++holdSize;
+        ++detectorCount;
+
+        // Moving average of the same length turns the steps into ramps
+        // that still reach the minimum by the time the peak comes out
+        const float held = holdValues[(size_t) holdFront];
+        boxSum += held - boxValues[(size_t) boxPos];
+        boxValues[(size_t) boxPos] = held;
+        boxPos = (boxPos + 1) % capacity;
+
+        gains[(size_t) i] = jmin(1.0f, (float) (boxSum / lookahead));
+    }
+
+    gainStateIsClear = false;
+}
+
+void MasterBus::resetGainState()
+{
+    if (gainStateIsClear) return;
+
+    envelope = 1.0f;
+    holdFront = 0;
+    holdSize = 0;
+    detectorCount = 0;
+
+    std::fill(boxValues.begin(), boxValues.end(), 1.0f);
+    boxSum = (double) lookahead;
+    boxPos = 0;
+
+    gainStateIsClear = true;
+}
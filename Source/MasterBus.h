@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    MasterBus.h
+    Created: 18 Oct 2026 4:05:41pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+#include "LevelMeterSource.h"
+
+/** Processing on the summed output of the decks: a look-ahead true-peak
+    limiter followed by the master level meter.
+
+    The limiter estimates inter-sample peaks by 4x polyphase interpolation,
+    and delays the audio by a short look-ahead so the gain is already down
+    when a peak arrives instead of clipping it. Every buffer is allocated in
+    prepare(), so it can stay on permanently, even with tiny device buffers.
+*/
+class MasterBus
+{
+public:
+    MasterBus() = default;
+
+    /** Allocate the delay line and scratch buffers (not while processing) */
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    /** Limit and meter a stereo block in place (audio thread) */
+    void process(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /** Turn the limiter on or off. The delay stays in either case, so
+        toggling it never makes the output jump. */
+    void setLimiterEnabled(bool shouldBeEnabled) { limiterEnabled = shouldBeEnabled; }
+    /** Check whether the limiter is on */
+    bool isLimiterEnabled() const { return limiterEnabled.load(); }
+
+    /** Set the highest true-peak level the output may reach, in dBTP */
+    void setCeilingDb(float newCeilingDb) { ceilingGain = Decibels::decibelsToGain(jmin(0.0f, newCeilingDb)); }
+    /** Set how quickly the gain recovers after a peak, in milliseconds */
+    void setReleaseMs(float newReleaseMs) { releaseMs = jmax(1.0f, newReleaseMs); }
+
+    /** Return how far the output lags the decks, in samples */
+    int getLatencyInSamples() const { return delaySamples; }
+
+    /** Return the current gain reduction in dB, with a falling hold (any thread) */
+    float getGainReductionDb() const { return gainReductionDb.load(); }
+    /** Return the output level meter */
+    const LevelMeterSource& getMeter() const { return meter; }
+
+private:
+    void processChunk(AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void computeTruePeaks(int numChannels, int numSamples);
+    void computeGains(int numSamples);
+    void resetGainState();
+
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 8;
+    static constexpr int historyLength = tapsPerPhase - 1;
+    static constexpr int detectorLatency = tapsPerPhase / 2;
+    static constexpr double lookaheadSeconds = 0.0015;
+
+    double sampleRate = 44100.0;
+    int blockSize = 0;
+    int lookahead = 1;
+    int delaySamples = 0;
+
+    // Interpolation filters for the fractional positions 1/4, 2/4 and 3/4
+    float phaseCoefficients[oversampling - 1][tapsPerPhase] {};
+
+    AudioBuffer<float> delayLine;
+    int delayWritePos = 0;
+
+    AudioBuffer<float> detectorInput;   // [last 7 samples | this block], per channel
+    std::vector<float> truePeaks, interpolated, gains;
+
+    float envelope = 1.0f;
+    std::vector<float> holdValues;      // running minimum over the look-ahead
+    std::vector<int64> holdIndices;
+    int holdFront = 0, holdSize = 0;
+    int64 detectorCount = 0;
+
+    std::vector<float> boxValues;       // moving average that smooths the gain
+    double boxSum = 0.0;
+    int boxPos = 0;
+    bool gainStateIsClear = true;
+
+    float gainReductionHold = 0.0f;
+
+    std::atomic<bool> limiterEnabled { true };
+    std::atomic<float> ceilingGain { Decibels::decibelsToGain(-1.0f) };
+    std::atomic<float> releaseMs { 80.0f };
+    std::atomic<float> gainReductionDb { 0.0f };
+
+    LevelMeterSource meter;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MasterBus)
+};
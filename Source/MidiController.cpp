@@ -0,0 +1,350 @@
+/*
+  ==============================================================================
+
+    MidiController.cpp
+    Created: 18 Oct 2026 8:02:19pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "MidiController.h"
+
+namespace
+{
+    // 33 1/3 rpm, as on the GUI's jog wheel
+    constexpr double turnsPerSecond = 100.0 / 3.0 / 60.0;
+
+    constexpr int jogTimerMs = 10;
+
+    // How much of each new jog reading is taken, to steady the ticks
+    constexpr double jogSmoothing = 0.5;
+
+    /** Map a 7-bit value to -1..1 with 64 in the middle */
+    double centred(int value)
+    {
+        return jlimit(-1.0, 1.0, (value - 64) / 63.0);
+    }
+}
+
+//==============================================================================
+MidiController::MidiController(DJMixer& mixerToControl)
+    : mixer(mixerToControl)
+{
+    for (auto& m : mappings)
+        m.store(-1);
+
+    loadMappings();
+}
+
+MidiController::~MidiController()
+{
+    closeInput();
+    cancelPendingUpdate();
+}
+
+bool MidiController::openInput(const String& deviceIdentifier)
+{
+    closeInput();
+
+    input = MidiInput::openDevice(deviceIdentifier, this);
+    if (input == nullptr) return false;
+
+    input->start();
+    startTimer(jogTimerMs);
+    return true;
+}
+
+bool MidiController::openVirtualInput(const String& portName)
+{
+    closeInput();
+
+    input = MidiInput::createNewDevice(portName, this);
+    if (input == nullptr) return false;
+
+    input->start();
+    startTimer(jogTimerMs);
+    return true;
+}
+
+void MidiController::closeInput()
+{
+    if (input != nullptr)
+        input->stop();
+
+    // The timer and the callback are finished once these return
+    stopTimer();
+    input.reset();
+
+    // Let go of any platter the controller was holding
+    for (int deck = 0; deck < jmin(maxDecks, mixer.getNumDecks()); ++deck)
+    {
+        auto& jog = jogs[(size_t) deck];
+
+        if (jog.touched.exchange(false))
+            send(deck, DeckCommand::Type::scratch, 0.0);
+
+        jog.ticks.store(0);
+        jog.rate = jog.sentRate = 0.0;
+    }
+}
+
+String MidiController::getInputName() const
+{
+    return input != nullptr ? input->getName() : String();
+}
+
+void MidiController::startLearning(int deck, Action action)
+{
+    if (! isPositiveAndBelow(deck, jmin(maxDecks, mixer.getNumDecks()))) return;
+
+    learnTarget.store(deck * (int) Action::numActions + (int) action);
+}
+
+void MidiController::clearMappings()
+{
+    for (auto& m : mappings)
+        m.store(-1);
+
+    saveMappings();
+}
+
+//==============================================================================
+void MidiController::handleIncomingMidiMessage(MidiInput*, const MidiMessage& message)
+{
+    handleMessage(message);
+}
+
+void MidiController::handleMessage(const MidiMessage& message)
+{
+    int key = 0;
+    int value = 0;
+
+    if (message.isController())
+    {
+        key = getKey(false, message.getChannel(), message.getControllerNumber());
+        value = message.getControllerValue();
+    }
+    else if (message.isNoteOnOrOff())
+    {
+        key = getKey(true, message.getChannel(), message.getNoteNumber());
+        value = message.isNoteOn() ? (int) message.getVelocity() : 0;
+    }
+    else
+    {
+        return;
+    }
+
+    // Learning takes the first control that moves. A control is bound to
+    // one message, so any older binding of it goes.
+    const int target = learnTarget.exchange(-1);
+    if (target >= 0)
+    {
+        for (auto& m : mappings)
+        {
+            int expected = target;
+            m.compare_exchange_strong(expected, -1);
+        }
+
+        mappings[(size_t) key].store(target);
+        lastLearnt.store(target);
+        triggerAsyncUpdate();
+        return;
+    }
+
+    const int mapping = mappings[(size_t) key].load();
+    if (mapping < 0) return;
+
+    const int deck = mapping / (int) Action::numActions;
+    if (deck < mixer.getNumDecks())
+        perform(deck, (Action) (mapping % (int) Action::numActions), value);
+}
+
+void MidiController::perform(int deck, Action action, int value)
+{
+    using Type = DeckCommand::Type;
+    auto& player = mixer.getDeck(deck);
+
+    switch (action)
+    {
+        case Action::play:
+            if (value > 0)
+                send(deck, player.isPlaying() ? Type::stop : Type::start, 0.0);
+            break;
+
+        case Action::hotCue1:
+        case Action::hotCue2:
+        case Action::hotCue3:
+        case Action::hotCue4:
+            if (value > 0)
+            {
+                const int slot = (int) action - (int) Action::hotCue1;
+                const double secs = player.getHotCueSeconds(slot);
+                if (secs >= 0.0)
+                    send(deck, Type::jumpToCue, secs, slot);
+            }
+            break;
+
+        case Action::volume: send(deck, Type::setGain, value / 127.0); break;
+        case Action::speed:  send(deck, Type::setSpeed, std::pow(2.0, centred(value))); break;
+        case Action::lowEQ:  send(deck, Type::setLowEQ, centred(value) * 12.0); break;
+        case Action::midEQ:  send(deck, Type::setMidEQ, centred(value) * 12.0); break;
+        case Action::highEQ: send(deck, Type::setHighEQ, centred(value) * 12.0); break;
+        case Action::filter: send(deck, Type::setFilter, centred(value)); break;
+
+        case Action::jogTouch:
+            if (deck < maxDecks)
+            {
+                auto& jog = jogs[(size_t) deck];
+                jog.ticks.store(0);
+                jog.touched.store(value > 0);
+                send(deck, Type::scratch, value > 0 ? 1.0 : 0.0);
+            }
+            break;
+
+        case Action::jogTurn:
+            // Two's complement: 1 to 63 forwards, 127 down to 65 backwards
+            if (deck < maxDecks)
+                jogs[(size_t) deck].ticks.fetch_add(value < 64 ? value : value - 128);
+            break;
+
+        case Action::numActions:
+            break;
+    }
+}
+
+void MidiController::send(int deck, DeckCommand::Type type, double value, int index)
+{
+    DeckCommand command;
+    command.type = type;
+    command.value = value;
+    command.index = index;
+
+    const ScopedLock sl(sendLock);
+    mixer.getDeck(deck).scheduleCommand(command, true);
+}
+
+void MidiController::hiResTimerCallback()
+{
+    const double now = Time::getMillisecondCounterHiRes();
+    const double seconds = jlimit(0.001, 0.1, (now - lastTimerMs) * 0.001);
+    lastTimerMs = now;
+
+    const double ticksPerTurn = (double) jogTicksPerTurn.load();
+
+    for (int deck = 0; deck < jmin(maxDecks, mixer.getNumDecks()); ++deck)
+    {
+        auto& jog = jogs[(size_t) deck];
+        const int ticks = jog.ticks.exchange(0);
+
+        if (! jog.touched.load())
+        {
+            jog.rate = jog.sentRate = 0.0;
+            continue;
+        }
+
+        const double measured = ticks / ticksPerTurn / seconds / turnsPerSecond;
+        jog.rate += (measured - jog.rate) * jogSmoothing;
+        if (std::abs(jog.rate) < 0.01) jog.rate = 0.0;
+
+        if (std::abs(jog.rate - jog.sentRate) > 0.005 || (jog.rate == 0.0 && jog.sentRate != 0.0))
+        {
+            jog.sentRate = jog.rate;
+            send(deck, DeckCommand::Type::scratchRate, jlimit(-8.0, 8.0, jog.rate));
+        }
+    }
+}
+
+void MidiController::handleAsyncUpdate()
+{
+    saveMappings();
+
+    const int learnt = lastLearnt.exchange(-1);
+    if (learnt >= 0 && onLearnt != nullptr)
+        onLearnt(learnt / (int) Action::numActions, (Action) (learnt % (int) Action::numActions));
+}
+
+//==============================================================================
+String MidiController::getActionName(Action action)
+{
+    switch (action)
+    {
+        case Action::play:     return "play";
+        case Action::hotCue1:  return "hotCue1";
+        case Action::hotCue2:  return "hotCue2";
+        case Action::hotCue3:  return "hotCue3";
+        case Action::hotCue4:  return "hotCue4";
+        case Action::volume:   return "volume";
+        case Action::speed:    return "speed";
+        case Action::lowEQ:    return "lowEQ";
+        case Action::midEQ:    return "midEQ";
+        case Action::highEQ:   return "highEQ";
+        case Action::filter:   return "filter";
+        case Action::jogTouch: return "jogTouch";
+        case Action::jogTurn:  return "jogTurn";
+        case Action::numActions: break;
+    }
+
+    return {};
+}
+
+File MidiController::getMappingsFile() const
+{
+    auto dir = File::getSpecialLocation(File::userApplicationDataDirectory)
+                    .getChildFile("Otodecks");
+    if (! dir.exists())
+        dir.createDirectory();
+    return dir.getChildFile("midi.json");
+}
+
+void MidiController::loadMappings()
+{
+    const auto file = getMappingsFile();
+    if (! file.existsAsFile()) return;
+
+    const auto json = JSON::parse(file.loadFileAsString());
+    if (! json.isArray()) return;
+
+    for (const auto& entry : *json.getArray())
+    {
+        const int channel = (int) entry.getProperty("channel", 0);
+        const int number = (int) entry.getProperty("number", -1);
+        const int deck = (int) entry.getProperty("deck", -1);
+        const auto name = entry.getProperty("action", {}).toString();
+
+        if (channel < 1 || channel > 16 || ! isPositiveAndBelow(number, 128)
+            || ! isPositiveAndBelow(deck, maxDecks))
+            continue;
+
+        for (int a = 0; a < (int) Action::numActions; ++a)
+        {
+            if (getActionName((Action) a) == name)
+            {
+                const bool isNote = entry.getProperty("type", {}).toString() == "note";
+                mappings[(size_t) getKey(isNote, channel, number)].store(deck * (int) Action::numActions + a);
+                break;
+            }
+        }
+    }
+}
+
+void MidiController::saveMappings() const
+{
+    Array<var> entries;
+
+    for (int key = 0; key < numKeys; ++key)
+    {
+        const int mapping = mappings[(size_t) key].load();
+        if (mapping < 0) continue;
+
+        auto* entry = new DynamicObject();
+        entry->setProperty("type", key >= 16 * 128 ? "note" : "cc");
+        entry->setProperty("channel", (key % (16 * 128)) / 128 + 1);
+        entry->setProperty("number", key % 128);
+        entry->setProperty("deck", mapping / (int) Action::numActions);
+        entry->setProperty("action", getActionName((Action) (mapping % (int) Action::numActions)));
+        entries.add(var(entry));
+    }
+
+    getMappingsFile().replaceWithText(JSON::toString(var(entries)));
+}
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    MidiController.h
+    Created: 18 Oct 2026 8:02:19pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "DJMixer.h"
+
+/** Drives the decks from a MIDI controller.
+
+    Messages are translated on the MIDI input's own thread and sent straight
+    to each deck's controller command queue, so a knob or a jog wheel reaches
+    the audio thread without going through the message thread; how busy the
+    GUI is makes no difference to the latency. The GUI catches up from the
+    decks' control values afterwards.
+
+    Mappings are learnt: startLearning() picks a deck control, and the next
+    note or CC that arrives is bound to it. The table is a flat array of
+    atomics indexed by message, so learning never blocks the MIDI thread.
+    Mappings are saved next to the hot cues.
+
+    The jog wheel's ticks are turned into a platter rate by a 100 Hz timer,
+    while the wheel is touched.
+*/
+class MidiController : private MidiInputCallback,
+                       private HighResolutionTimer,
+                       private AsyncUpdater
+{
+public:
+    enum class Action
+    {
+        play,       // note: toggles play/stop
+        hotCue1,    // note: jumps to the hot cue
+        hotCue2,
+        hotCue3,
+        hotCue4,
+        volume,     // CC: 0 to 127
+        speed,      // CC: 64 is normal, 0 half speed, 127 double
+        lowEQ,      // CC: 64 is flat, +/- 12 dB
+        midEQ,
+        highEQ,
+        filter,     // CC: 64 is off, below low-pass, above high-pass
+        jogTouch,   // note: on while the wheel is touched
+        jogTurn,    // relative CC: 1-63 forwards, 65-127 backwards
+        numActions
+    };
+
+    explicit MidiController(DJMixer& mixerToControl);
+    ~MidiController() override;
+
+    /** Open a MIDI input by its device identifier, closing any other */
+    bool openInput(const String& deviceIdentifier);
+    /** Create a virtual MIDI input other programs can send to, closing any
+        other (macOS and Linux only) */
+    bool openVirtualInput(const String& portName);
+    /** Close the open input */
+    void closeInput();
+    /** Return the name of the open input (empty if none) */
+    String getInputName() const;
+
+    /** Bind the next note or CC that arrives to a deck control */
+    void startLearning(int deck, Action action);
+    /** Stop waiting for a message to learn */
+    void cancelLearning() { learnTarget.store(-1); }
+    /** Check whether a control is waiting for a message to learn */
+    bool isLearning() const { return learnTarget.load() >= 0; }
+    /** Remove every mapping */
+    void clearMappings();
+
+    /** Called on the message thread when a mapping has been learnt */
+    std::function<void(int deck, Action action)> onLearnt;
+
+    /** Handle a message as if it had come from the open input (one thread at a time) */
+    void handleMessage(const MidiMessage& message);
+
+    /** Set how many jog ticks make one turn of the platter */
+    void setJogResolution(int ticksPerTurn) { jogTicksPerTurn.store(jmax(1, ticksPerTurn)); }
+
+    /** Return the display name of an action */
+    static String getActionName(Action action);
+
+private:
+    void handleIncomingMidiMessage(MidiInput* source, const MidiMessage& message) override;
+    void hiResTimerCallback() override;
+    void handleAsyncUpdate() override;
+
+    void perform(int deck, Action action, int value);
+    void send(int deck, DeckCommand::Type type, double value, int index = -1);
+
+    static int getKey(bool isNote, int channel, int number) { return (isNote ? 16 * 128 : 0) + (channel - 1) * 128 + number; }
+
+    File getMappingsFile() const;
+    void loadMappings();
+    void saveMappings() const;
+
+    static constexpr int numKeys = 2 * 16 * 128;
+    static constexpr int maxDecks = 4;
+
+    DJMixer& mixer;
+
+    std::unique_ptr<MidiInput> input;
+
+    // deck * numActions + action for every note (upper half) and CC, or -1
+    std::array<std::atomic<int>, numKeys> mappings;
+    std::atomic<int> learnTarget { -1 };
+    std::atomic<int> lastLearnt { -1 };
+
+    // Jog wheels, written by the MIDI thread and read by the timer
+    struct Jog
+    {
+        std::atomic<bool> touched { false };
+        std::atomic<int> ticks { 0 };
+        double rate = 0.0;
+        double sentRate = 0.0;
+    };
+    std::array<Jog, maxDecks> jogs;
+    std::atomic<int> jogTicksPerTurn { 512 };
+    double lastTimerMs = 0.0;
+
+    // The MIDI and timer threads both send commands; each deck's controller
+    // queue takes one producer at a time
+    CriticalSection sendLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiController)
+};
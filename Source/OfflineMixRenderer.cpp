@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+    OfflineMixRenderer.cpp
+    Created: 18 Oct 2026 10:41:57am
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "OfflineMixRenderer.h"
+
+OfflineMixRenderer::OfflineMixRenderer(AudioFormatManager& _formatManager)
+: formatManager(_formatManager)
+{
+}
+
+Result OfflineMixRenderer::render(const ControlLog& log,
+                                  const File& outputFile,
+                                  int blockSize,
+                                  ProgressCallback progress)
+{
+    if (log.getLengthInSamples() <= 0)
+        return Result::fail("The control log is empty");
+
+    outputFile.deleteFile();
+
+    std::unique_ptr<FileOutputStream> stream(outputFile.createOutputStream());
+    if (stream == nullptr)
+        return Result::fail("Could not open " + outputFile.getFullPathName() + " for writing");
+
+    WavAudioFormat wav;
+    std::unique_ptr<AudioFormatWriter> writer(
+        wav.createWriterFor(stream.get(), log.getSampleRate(), 2, 32, {}, 0));
+
+    if (writer == nullptr)
+        return Result::fail("Could not create a WAV writer");
+
+    stream.release(); // the writer owns the stream now
+
+    // The disk writes happen on a background thread so the render loop
+    // only ever copies into the writer's FIFO.
+    TimeSliceThread writerThread("Mix export writer");
+    writerThread.startThread();
+
+    Result result = Result::ok();
+
+    {
+        AudioFormatWriter::ThreadedWriter threadedWriter(writer.release(), writerThread, 1 << 17);
+
+        result = renderBlocks(log, blockSize,
+            [&threadedWriter](const AudioBuffer<float>& block, int numSamples)
+            {
+                // If the FIFO is full, wait for the writer thread to drain it
+                while (! threadedWriter.write(block.getArrayOfReadPointers(), numSamples))
+                    Thread::sleep(1);
+
+                return true;
+            },
+            progress);
+    } // ThreadedWriter flushes everything that is still queued here
+
+    writerThread.stopThread(2000);
+
+    if (result.failed())
+        outputFile.deleteFile();
+
+    return result;
+}
+
+Result OfflineMixRenderer::renderToBuffer(const ControlLog& log,
+                                          AudioBuffer<float>& destination,
+                                          int blockSize)
+{
+    const auto length = log.getLengthInSamples();
+    if (length <= 0 || length > std::numeric_limits<int>::max())
+        return Result::fail("The control log has an invalid length");
+
+    destination.setSize(2, (int) length);
+    destination.clear();
+
+    int writePos = 0;
+
+    return renderBlocks(log, blockSize,
+        [&destination, &writePos](const AudioBuffer<float>& block, int numSamples)
+        {
+            for (int ch = 0; ch < destination.getNumChannels(); ++ch)
+                destination.copyFrom(ch, writePos, block, ch, 0, numSamples);
+
+            writePos += numSamples;
+            return true;
+        },
+        nullptr);
+}
+
+Result OfflineMixRenderer::renderBlocks(const ControlLog& log, int blockSize,
+                                        const BlockWriter& writeBlock,
+                                        const ProgressCallback& progress)
+{
+    blockSize = jlimit(16, 8192, blockSize);
+
+    const auto events = log.getEvents();
+    const auto totalSamples = log.getLengthInSamples();
+
+    DJMixer mixer(formatManager, log.getNumDecks());
+    mixer.setNonRealtime(true);
+    mixer.prepareToPlay(blockSize, log.getSampleRate());
+
+    AudioBuffer<float> buffer(2, blockSize);
+
+    size_t nextEvent = 0;
+    int64 blockStart = 0;
+
+    while (blockStart < totalSamples)
+    {
+        const int numSamples = (int) jmin((int64) blockSize, totalSamples - blockStart);
+        const int64 blockEnd = blockStart + numSamples;
+
+        buffer.clear();
+
+        // Parameter and transport events are queued on their deck with their
+        // own timestamp, so the deck applies them on the exact sample. Loads
+        // are synchronous, so the block is split wherever one falls inside it.
+        int64 segmentStart = blockStart;
+
+        while (segmentStart < blockEnd)
+        {
+            while (nextEvent < events.size() && events[nextEvent].sampleTime < blockEnd)
+            {
+                const auto& e = events[nextEvent];
+
+                if ((e.type == ControlLog::EventType::load || e.type == ControlLog::EventType::impulse)
+                    && e.sampleTime > segmentStart)
+                    break;
+
+                if (! applyEvent(mixer, e))
+                    break; // queue full: render up to here so the deck can drain it
+
+                ++nextEvent;
+            }
+
+            int64 segmentEnd = blockEnd;
+            if (nextEvent < events.size())
+                segmentEnd = jlimit(segmentStart + 1, blockEnd, events[nextEvent].sampleTime);
+
+            AudioSourceChannelInfo info(&buffer,
+                                        (int) (segmentStart - blockStart),
+                                        (int) (segmentEnd - segmentStart));
+            mixer.getNextAudioBlock(info);
+
+            segmentStart = segmentEnd;
+        }
+
+        if (! writeBlock(buffer, numSamples))
+        {
+            mixer.releaseResources();
+            return Result::fail("Writing the rendered audio failed");
+        }
+
+        blockStart = blockEnd;
+
+        if (progress != nullptr && ! progress((double) blockStart / (double) totalSamples))
+        {
+            mixer.releaseResources();
+            return Result::fail("Render cancelled");
+        }
+    }
+
+    mixer.releaseResources();
+    return Result::ok();
+}
+
+bool OfflineMixRenderer::applyEvent(DJMixer& mixer, const ControlLog::Event& e)
+{
+    if (e.type == ControlLog::EventType::impulse)
+    {
+        mixer.loadReverbImpulse(File(e.path), true);
+        return true;
+    }
+
+    if (e.deck < 0 || e.deck >= mixer.getNumDecks()) return true;
+
+    auto& deck = mixer.getDeck(e.deck);
+
+    DeckCommand command;
+    command.value = e.value;
+    command.targetSample = e.sampleTime;
+
+    switch (e.type)
+    {
+        case ControlLog::EventType::load:   deck.loadURL(URL(e.path), true); return true;
+        case ControlLog::EventType::play:   command.type = DeckCommand::Type::start; break;
+        case ControlLog::EventType::stop:   command.type = DeckCommand::Type::stop; break;
+        case ControlLog::EventType::seek:   command.type = DeckCommand::Type::setPosition; break;
+        case ControlLog::EventType::speed:  command.type = DeckCommand::Type::setSpeed; break;
+        case ControlLog::EventType::gain:   command.type = DeckCommand::Type::setGain; break;
+        case ControlLog::EventType::lowEQ:  command.type = DeckCommand::Type::setLowEQ; break;
+        case ControlLog::EventType::midEQ:  command.type = DeckCommand::Type::setMidEQ; break;
+        case ControlLog::EventType::highEQ: command.type = DeckCommand::Type::setHighEQ; break;
+        case ControlLog::EventType::loopIn:     command.type = DeckCommand::Type::loopIn; break;
+        case ControlLog::EventType::loopOut:    command.type = DeckCommand::Type::loopOut; break;
+        case ControlLog::EventType::beatLoop:   command.type = DeckCommand::Type::beatLoop; break;
+        case ControlLog::EventType::loopHalve:  command.type = DeckCommand::Type::loopHalve; break;
+        case ControlLog::EventType::loopDouble: command.type = DeckCommand::Type::loopDouble; break;
+        case ControlLog::EventType::loopExit:   command.type = DeckCommand::Type::loopExit; break;
+        case ControlLog::EventType::slip:       command.type = DeckCommand::Type::setSlip; break;
+        case ControlLog::EventType::sync:       command.type = DeckCommand::Type::setSync; break;
+        case ControlLog::EventType::filter:     command.type = DeckCommand::Type::setFilter; break;
+        case ControlLog::EventType::flanger:    command.type = DeckCommand::Type::setFlanger; break;
+        case ControlLog::EventType::echo:       command.type = DeckCommand::Type::setEcho; break;
+        case ControlLog::EventType::reverbSend: command.type = DeckCommand::Type::setReverbSend; break;
+        case ControlLog::EventType::scratch:    command.type = DeckCommand::Type::scratch; break;
+        case ControlLog::EventType::scratchRate: command.type = DeckCommand::Type::scratchRate; break;
+        case ControlLog::EventType::impulse:    return true;
+    }
+
+    return deck.scheduleCommand(command);
+}
@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    OfflineMixRenderer.h
+    Created: 18 Oct 2026 10:41:57am
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include "ControlLog.h"
+#include "DJMixer.h"
+
+/** Replays a ControlLog through a private DJMixer as fast as the CPU allows
+    and writes the mix to a WAV file.
+
+    No sound card is involved: the mixer is pulled in fixed-size blocks and
+    each block is split at event timestamps, so every control change lands
+    on exactly the sample it was recorded at. The output is written as
+    32-bit float through a background writer thread and is bit-exact
+    across runs for the same log and source files.
+*/
+class OfflineMixRenderer
+{
+public:
+    OfflineMixRenderer(AudioFormatManager& formatManager);
+
+    /** Called after each block with the fraction rendered so far.
+        Return false to cancel the render. */
+    using ProgressCallback = std::function<bool (double progress)>;
+
+    /** Render the whole log into a WAV file, replacing it if it exists */
+    Result render(const ControlLog& log,
+                  const File& outputFile,
+                  int blockSize = 512,
+                  ProgressCallback progress = nullptr);
+
+    /** Render the log into a buffer instead of a file (used by the benchmark's
+        determinism check) */
+    Result renderToBuffer(const ControlLog& log,
+                          AudioBuffer<float>& destination,
+                          int blockSize = 512);
+
+private:
+    using BlockWriter = std::function<bool (const AudioBuffer<float>& block, int numSamples)>;
+
+    Result renderBlocks(const ControlLog& log, int blockSize,
+                        const BlockWriter& writeBlock, const ProgressCallback& progress);
+
+    /** Load the event's track, or queue the event on its deck at its own
+        sample time. Returns false if the deck's command queue is full. */
+    static bool applyEvent(DJMixer& mixer, const ControlLog::Event& e);
+
+    AudioFormatManager& formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OfflineMixRenderer)
+};
@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "PlaylistComponent.h"
+#include "DurationProbe.h"
 
 //==============================================================================
 PlaylistComponent::PlaylistComponent(AudioFormatManager& _formatManager)
@@ -17,14 +18,20 @@ PlaylistComponent::PlaylistComponent(AudioFormatManager& _formatManager)
 {
     tableComponent.getHeader().addColumn("Track title", 1, 400);
     tableComponent.getHeader().addColumn("Duration", 2, 150);
+    tableComponent.getHeader().addColumn("Preview", 6, 160);
     tableComponent.getHeader().addColumn("Deck 1", 3, 120);
     tableComponent.getHeader().addColumn("Deck 2", 4, 120);
+    tableComponent.getHeader().addColumn("Queue", 5, 120);
 
     tableComponent.setModel(this);
 
     addAndMakeVisible(addButton);
     addButton.addListener(this);
 
+    addChildComponent(importProgressBar);
+    addChildComponent(cancelImportButton);
+    cancelImportButton.addListener(this);
+
     addAndMakeVisible(tableComponent);
 
     loadLibrary();
@@ -32,7 +39,11 @@ PlaylistComponent::PlaylistComponent(AudioFormatManager& _formatManager)
 
 PlaylistComponent::~PlaylistComponent()
 {
-    saveLibrary();
+    stopTimer();
+    ++importGeneration;
+    importPool.removeAllJobs(true, 4000);
+    previewPool.removeAllJobs(true, 4000);
+    cancelPendingUpdate();
 }
 
 void PlaylistComponent::paint (juce::Graphics& g)
@@ -54,12 +65,14 @@ void PlaylistComponent::resized()
     auto top = area.removeFromTop(40);
 
     addButton.setBounds(top.removeFromLeft(160).reduced(5));
+    importProgressBar.setBounds(top.removeFromLeft(260).reduced(5));
+    cancelImportButton.setBounds(top.removeFromLeft(90).reduced(5));
     tableComponent.setBounds(area);
 }
 
 int PlaylistComponent::getNumRows()
 {
-    return (int)tracks.size();
+    return library.getNumTracks();
 }
 
 void PlaylistComponent::paintRowBackground(Graphics & g,
@@ -85,11 +98,13 @@ void PlaylistComponent::paintCell(Graphics & g,
                                   int height,
                                   bool rowIsSelected)
 {
-    if (rowNumber < 0 || rowNumber >= (int)tracks.size()) return;
+    if (rowNumber < 0 || rowNumber >= library.getNumTracks()) return;
+
+    const auto& track = library.getTrack(rowNumber);
 
     if (columnId == 1)
     {
-        g.drawText(tracks[rowNumber].fileName,
+        g.drawText(track.fileName,
                    2, 0,
                    width - 4, height,
                    Justification::centredLeft,
@@ -98,7 +113,7 @@ void PlaylistComponent::paintCell(Graphics & g,
 
     if (columnId == 2)
     {
-        int totalSeconds = (int)std::round(tracks[rowNumber].durationSec);
+        int totalSeconds = (int)std::round(track.durationSec);
         int mins = totalSeconds / 60;
         int secs = totalSeconds % 60;
 
@@ -110,6 +125,15 @@ void PlaylistComponent::paintCell(Graphics & g,
                    Justification::centredLeft,
                    true);
     }
+
+    // Only ever drawn from the stored summary; a track without one yet is
+    // left blank until the preview thread gets to it
+    if (columnId == 6 && track.hasPreview)
+    {
+        drawPreview(g, track.preview,
+                    Rectangle<float>(2.0f, 2.0f, (float) width - 4.0f, (float) height - 4.0f),
+                    rowIsSelected);
+    }
 }
 
 Component* PlaylistComponent::refreshComponentForCell(int rowNumber,
@@ -117,21 +141,23 @@ Component* PlaylistComponent::refreshComponentForCell(int rowNumber,
                                                       bool isRowSelected,
                                                       Component *existingComponentToUpdate)
 {
-    if (columnId == 3 || columnId == 4)
+    if (columnId == 3 || columnId == 4 || columnId == 5)
     {
+        String prefix = columnId == 3 ? "deck1_" : columnId == 4 ? "deck2_" : "queue_";
+
         if (existingComponentToUpdate == nullptr)
         {
-            TextButton* btn = new TextButton{"Load"};
+            TextButton* btn = new TextButton{columnId == 5 ? "Queue" : "Load"};
             btn->addListener(this);
 
-            String id = (columnId == 3 ? "deck1_" : "deck2_") + String(rowNumber);
+            String id = prefix + String(rowNumber);
             btn->setComponentID(id);
 
             existingComponentToUpdate = btn;
         }
         else
         {
-            String id = (columnId == 3 ? "deck1_" : "deck2_") + String(rowNumber);
+            String id = prefix + String(rowNumber);
             existingComponentToUpdate->setComponentID(id);
         }
     }
@@ -148,39 +174,27 @@ void PlaylistComponent::buttonClicked(Button * button)
 
         fChooser.launchAsync(flags, [this](const FileChooser& fc)
         {
-            auto results = fc.getResults();
-
-            for (auto file : results)
-            {
-                if (file.existsAsFile())
-                {
-                    TrackInfo t;
-                    t.filePath = file.getFullPathName();
-                    t.fileName = file.getFileName();
-                    t.durationSec = getTrackDurationSec(file);
-
-                    tracks.push_back(t);
-                }
-            }
-
-            tableComponent.updateContent();
-            tableComponent.repaint();
-
-            saveLibrary();
+            startImport(fc.getResults());
         });
 
         return;
     }
 
+    if (button == &cancelImportButton)
+    {
+        cancelImport();
+        return;
+    }
+
     String id = button->getComponentID();
 
     if (id.startsWith("deck1_"))
     {
         int row = id.fromFirstOccurrenceOf("deck1_", false, false).getIntValue();
 
-        if (row >= 0 && row < (int)tracks.size() && loadToDeck1 != nullptr)
+        if (row >= 0 && row < library.getNumTracks() && loadToDeck1 != nullptr)
         {
-            loadToDeck1(File{tracks[row].filePath});
+            loadToDeck1(File{library.getTrack(row).filePath});
         }
 
         return;
@@ -190,89 +204,244 @@ void PlaylistComponent::buttonClicked(Button * button)
     {
         int row = id.fromFirstOccurrenceOf("deck2_", false, false).getIntValue();
 
-        if (row >= 0 && row < (int)tracks.size() && loadToDeck2 != nullptr)
+        if (row >= 0 && row < library.getNumTracks() && loadToDeck2 != nullptr)
         {
-            loadToDeck2(File{tracks[row].filePath});
+            loadToDeck2(File{library.getTrack(row).filePath});
+        }
+
+        return;
+    }
+
+    if (id.startsWith("queue_"))
+    {
+        int row = id.fromFirstOccurrenceOf("queue_", false, false).getIntValue();
+
+        if (row >= 0 && row < library.getNumTracks() && queueTrack != nullptr)
+        {
+            queueTrack(File{library.getTrack(row).filePath});
         }
 
         return;
     }
 }
 
-double PlaylistComponent::getTrackDurationSec(File file)
+bool PlaylistComponent::isInterestedInFileDrag(const StringArray& files)
 {
-    std::unique_ptr<InputStream> inputStream(file.createInputStream());
-    if (inputStream == nullptr) return 0.0;
+    for (auto& path : files)
+        if (formatManager.findFormatForFileExtension(File(path).getFileExtension()) != nullptr)
+            return true;
 
-    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(std::move(inputStream)));
-    if (reader == nullptr) return 0.0;
+    return false;
+}
 
-    if (reader->sampleRate <= 0) return 0.0;
+void PlaylistComponent::filesDropped(const StringArray& files, int, int)
+{
+    Array<File> dropped;
+    for (auto& path : files)
+        dropped.add(File(path));
 
-    return (double)reader->lengthInSamples / reader->sampleRate;
+    startImport(dropped);
 }
 
-File PlaylistComponent::getLibraryFile()
+void PlaylistComponent::startImport(const Array<File>& files)
 {
-    auto dir = File::getSpecialLocation(File::userApplicationDataDirectory)
-                    .getChildFile("Otodecks");
+    // Only files a reader exists for; anything else dropped alongside them
+    // would become an empty row
+    Array<File> toImport;
+    for (auto& file : files)
+        if (file.existsAsFile() && formatManager.findFormatForFileExtension(file.getFileExtension()) != nullptr)
+            toImport.add(file);
+
+    if (toImport.isEmpty()) return;
+
+    size_t first;
+    {
+        const ScopedLock sl(importLock);
+        first = importSlots.size();
+        importSlots.resize(first + (size_t) toImport.size());
+    }
+
+    const int generation = importGeneration.load();
 
-    if (!dir.exists())
+    for (int i = 0; i < toImport.size(); ++i)
     {
-        dir.createDirectory();
+        importPool.addJob([this, file = toImport[i], slot = first + (size_t) i, generation]
+        {
+            if (generation != importGeneration.load())
+                return;
+
+            LibraryStore::Track t;
+            t.filePath = file.getFullPathName();
+            t.fileName = file.getFileName();
+            t.durationSec = DurationProbe::getDurationSec(file, formatManager);
+
+            const ScopedLock sl(importLock);
+            if (generation != importGeneration.load())
+                return;
+
+            importSlots[slot].track = std::move(t);
+            importSlots[slot].done = true;
+        });
     }
 
-    return dir.getChildFile("library.json");
+    importProgressBar.setVisible(true);
+    cancelImportButton.setVisible(true);
+    startTimerHz(10);
 }
 
-void PlaylistComponent::loadLibrary()
+void PlaylistComponent::cancelImport()
 {
-    File file = getLibraryFile();
-    if (!file.existsAsFile()) return;
+    // Running jobs see the new generation and throw their results away
+    ++importGeneration;
+    importPool.removeAllJobs(false, 0);
 
-    auto jsonText = file.loadFileAsString();
-    auto parsed = JSON::parse(jsonText);
+    {
+        const ScopedLock sl(importLock);
+        importSlots.clear();
+        nextImport = 0;
+    }
 
-    if (!parsed.isArray()) return;
+    stopTimer();
+    importProgress = 0.0;
+    importProgressBar.setVisible(false);
+    cancelImportButton.setVisible(false);
+}
 
-    auto* arr = parsed.getArray();
-    if (arr == nullptr) return;
+void PlaylistComponent::timerCallback()
+{
+    std::vector<LibraryStore::Track> ready;
+    size_t total;
+    {
+        const ScopedLock sl(importLock);
 
-    tracks.clear();
+        // Keep the order the files were chosen in
+        while (nextImport < importSlots.size() && importSlots[nextImport].done)
+            ready.push_back(std::move(importSlots[nextImport++].track));
 
-    for (auto& item : *arr)
+        total = importSlots.size();
+    }
+
+    if (! ready.empty())
     {
-        if (!item.isObject()) continue;
+        const int first = library.addAll(ready);
+        for (int row = first; row < library.getNumTracks(); ++row)
+            requestPreview(row);
+
+        tableComponent.updateContent();
+        tableComponent.repaint();
+    }
 
-        auto* obj = item.getDynamicObject();
-        if (obj == nullptr) continue;
+    importProgress = total > 0 ? (double) nextImport / (double) total : 1.0;
+    importProgressBar.setTextToDisplay("Importing " + String((int64) nextImport) + " of " + String((int64) total));
 
-        TrackInfo t;
-        t.filePath = obj->getProperty("filePath").toString();
-        t.fileName = obj->getProperty("fileName").toString();
-        t.durationSec = (double)obj->getProperty("durationSec");
+    if (nextImport >= total)
+    {
+        {
+            const ScopedLock sl(importLock);
+            importSlots.clear();
+            nextImport = 0;
+        }
 
-        tracks.push_back(t);
+        stopTimer();
+        importProgressBar.setVisible(false);
+        cancelImportButton.setVisible(false);
     }
+}
 
-    tableComponent.updateContent();
-    tableComponent.repaint();
+void PlaylistComponent::requestPreview(int row)
+{
+    previewPool.addJob([this, row, filePath = library.getTrack(row).filePath]
+    {
+        const File file(filePath);
+        FinishedPreview finished { row, filePath, {}, false };
+
+        // A track that has been on a deck is summarised from its cached
+        // waveform without decoding it again
+        if (auto pyramid = waveformCache->find(file))
+            finished.made = finished.preview.createFrom(*pyramid);
+
+        if (! finished.made)
+        {
+            auto* job = ThreadPoolJob::getCurrentThreadPoolJob();
+            std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+            if (reader != nullptr)
+                finished.made = finished.preview.createFrom(*reader, [job] { return job != nullptr && job->shouldExit(); });
+
+            if (job != nullptr && job->shouldExit())
+                return;
+        }
+
+        const ScopedLock sl(finishedLock);
+        finishedPreviews.push_back(std::move(finished));
+        triggerAsyncUpdate();
+    });
+}
+
+void PlaylistComponent::handleAsyncUpdate()
+{
+    std::vector<FinishedPreview> finished;
+    {
+        const ScopedLock sl(finishedLock);
+        finished.swap(finishedPreviews);
+    }
+
+    // Every preview finished since the last update goes into one journal write
+    std::vector<std::pair<int, LibraryStore::Track>> changes;
+
+    for (auto& f : finished)
+    {
+        if (! f.made || f.row >= library.getNumTracks() || library.getTrack(f.row).filePath != f.filePath)
+            continue;
+
+        auto track = library.getTrack(f.row);
+        track.preview = f.preview;
+        track.hasPreview = true;
+        changes.emplace_back(f.row, std::move(track));
+    }
+
+    library.updateAll(changes);
+
+    for (const auto& change : changes)
+        tableComponent.repaintRow(change.first);
 }
 
-void PlaylistComponent::saveLibrary()
+void PlaylistComponent::drawPreview(Graphics& g, const TrackPreview& preview,
+                                    Rectangle<float> area, bool rowIsSelected)
 {
-    Array<var> arr;
+    const float columnWidth = area.getWidth() / TrackPreview::numColumns;
+    const float halfHeight = area.getHeight() * 0.5f;
+    const float centreY = area.getCentreY();
 
-    for (auto& t : tracks)
+    RectangleList<float> peakBars, rmsBars;
+
+    for (int col = 0; col < TrackPreview::numColumns; ++col)
     {
-        DynamicObject::Ptr obj = new DynamicObject();
-        obj->setProperty("filePath", t.filePath);
-        obj->setProperty("fileName", t.fileName);
-        obj->setProperty("durationSec", t.durationSec);
+        const float x = area.getX() + col * columnWidth;
+        const float peak = jmax(0.5f, preview.peaks[(size_t) col] / 255.0f * halfHeight);
+        const float level = preview.rms[(size_t) col] / 255.0f * halfHeight;
 
-        arr.add(var(obj.get()));
+        peakBars.addWithoutMerging({ x, centreY - peak, columnWidth, peak * 2.0f });
+        if (level > 0.0f)
+            rmsBars.addWithoutMerging({ x, centreY - level, columnWidth, level * 2.0f });
     }
 
-    File file = getLibraryFile();
-    file.replaceWithText(JSON::toString(var(arr)));
+    const auto colour = rowIsSelected ? Colours::black : Colour(0, 170, 255);
+
+    g.setColour(colour.withAlpha(0.45f));
+    g.fillRectList(peakBars);
+    g.setColour(colour.withAlpha(0.9f));
+    g.fillRectList(rmsBars);
+}
+
+void PlaylistComponent::loadLibrary()
+{
+    library.open();
+
+    for (int row = 0; row < library.getNumTracks(); ++row)
+        if (! library.getTrack(row).hasPreview)
+            requestPreview(row);
+
+    tableComponent.updateContent();
+    tableComponent.repaint();
 }
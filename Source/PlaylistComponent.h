@@ -14,23 +14,30 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <atomic>
+#include "LibraryStore.h"
+#include "TrackPreview.h"
+#include "WaveformCache.h"
 
 
 //==============================================================================
 
 class PlaylistComponent  : public juce::Component,
                             public TableListBoxModel,
-                            public Button::Listener
+                            public Button::Listener,
+                            public FileDragAndDropTarget,
+                            private AsyncUpdater,
+                            private Timer
 {
 public:
     /** Create the playlist, loading any previously saved library */
     PlaylistComponent(AudioFormatManager& formatManager);
-    /** Save the library to disk on destruction */
+    /** Stop importing and making previews; the library is already on disk */
     ~PlaylistComponent() override;
 
     /** Draw the playlist background */
     void paint (juce::Graphics&) override;
-    /** Layout the add button and track table */
+    /** Layout the add button, import progress and track table */
     void resized() override;
 
     /** Return the number of tracks in the playlist */
@@ -42,7 +49,7 @@ public:
                             int height,
                             bool rowIsSelected) override;
 
-    /** Draw the text content of a table cell (name or duration) */
+    /** Draw the content of a table cell (name, duration or preview) */
     void paintCell(Graphics & g,
                    int rowNumber,
                    int columnId,
@@ -56,19 +63,28 @@ public:
                                        bool isRowSelected,
                                        Component *existingComponentToUpdate) override;
 
-    /** Handle add-tracks button and load-to-deck button clicks */
+    /** Handle add-tracks, cancel-import and load-to-deck button clicks */
     void buttonClicked(Button * button) override;
 
+    /** Accept audio files dragged onto the playlist */
+    bool isInterestedInFileDrag(const StringArray& files) override;
+    /** Import the files dropped onto the playlist */
+    void filesDropped(const StringArray& files, int x, int y) override;
+
     // R2B: MainComponent will set these callbacks
     std::function<void(File)> loadToDeck1;
     std::function<void(File)> loadToDeck2;
+    /** Prepare a track as the next one on whichever deck is free */
+    std::function<void(File)> queueTrack;
 
 private:
-    struct TrackInfo
+    /** A preview made in the background, waiting for the message thread */
+    struct FinishedPreview
     {
+        int row;
         String filePath;
-        String fileName;
-        double durationSec;
+        TrackPreview preview;
+        bool made;
     };
 
     AudioFormatManager& formatManager;
@@ -78,15 +94,52 @@ private:
     
     juce::FileChooser fChooser{"Select audio files...", File{}, "*.mp3;*.wav;*.aiff"};
 
-    std::vector<TrackInfo> tracks;
+    // Import progress, shown while an import runs
+    double importProgress = 0.0;
+    ProgressBar importProgressBar { importProgress };
+    TextButton cancelImportButton { "CANCEL" };
 
-    // R2C persistence helpers
-    File getLibraryFile();
+    // R2C persistence, one journal record per change
+    LibraryStore library;
     void loadLibrary();
-    void saveLibrary();
 
-    // R2A duration helper
-    double getTrackDurationSec(File file);
+    /** Probe files on the import pool; they are added in order as they finish */
+    void startImport(const Array<File>& files);
+    /** Drop the files not imported yet */
+    void cancelImport();
+    /** Add the tracks probed since the last tick to the library in one batch */
+    void timerCallback() override;
+
+    /** Make a track's mini-waveform on the preview thread */
+    void requestPreview(int row);
+    /** Take in the previews made since the last call and repaint their rows */
+    void handleAsyncUpdate() override;
+    /** Draw a mini-waveform, mirrored about the middle of an area */
+    static void drawPreview(Graphics& g, const TrackPreview& preview, Rectangle<float> area, bool rowIsSelected);
+
+    SharedResourcePointer<WaveformCache> waveformCache;
+
+    CriticalSection finishedLock;
+    std::vector<FinishedPreview> finishedPreviews;
+
+    /** A file being imported; slots are filled in any order by the pool */
+    struct ImportSlot
+    {
+        LibraryStore::Track track;
+        bool done = false;
+    };
+
+    CriticalSection importLock;
+    std::vector<ImportSlot> importSlots;
+    size_t nextImport = 0;                  // first slot not yet in the library
+    std::atomic<int> importGeneration { 0 };
+
+    // Declared last so their jobs are gone before anything they use
+    ThreadPool importPool { ThreadPoolOptions{}.withThreadName("Track import")
+                                               .withNumberOfThreads(jlimit(2, 8, SystemStats::getNumCpus())) };
+    ThreadPool previewPool { ThreadPoolOptions{}.withThreadName("Track previews")
+                                                .withNumberOfThreads(1)
+                                                .withDesiredThreadPriority(Thread::Priority::low) };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaylistComponent)
 };
@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+    ScratchPlayer.cpp
+    Created: 18 Oct 2026 7:11:05pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "ScratchPlayer.h"
+
+namespace
+{
+    // How quickly the platter follows the jog and the motor
+    constexpr double platterSeconds = 0.005;
+
+    // Below this speed the output fades out, as a cartridge's does, so a
+    // platter held still doesn't leave a DC offset
+    constexpr double silentRate = 0.05;
+}
+
+ScratchPlayer::ScratchPlayer(double sourceSampleRate)
+    : sourceRate(sourceSampleRate > 0.0 ? sourceSampleRate : 44100.0)
+{
+    capacity = (int) (sourceRate * windowSeconds);
+    ring.setSize(2, capacity);
+    ring.clear();
+    handover.setSize(2, maxHandoverSamples);
+}
+
+void ScratchPlayer::pushHistory(const AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                int64 positionAfter)
+{
+    if (numSamples <= 0) return;
+
+    int64 first = positionAfter - numSamples;
+
+    // Jumping back inside the window keeps the audio before the jump, which
+    // is still the track; anything else starts the window again
+    if (first < validStart || first > validEnd)
+        validStart = first;
+
+    if (numSamples > capacity)
+    {
+        startSample += numSamples - capacity;
+        first += numSamples - capacity;
+        numSamples = capacity;
+    }
+
+    const int index = (int) (first % capacity);
+    const int part = jmin(numSamples, capacity - index);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const int source = jmin(ch, buffer.getNumChannels() - 1);
+        ring.copyFrom(ch, index, buffer, source, startSample, part);
+        if (numSamples > part)
+            ring.copyFrom(ch, 0, buffer, source, startSample + part, numSamples - part);
+    }
+
+    validEnd = first + numSamples;
+    validStart = jmax(validStart, validEnd - capacity);
+}
+
+void ScratchPlayer::begin(int64 playhead, double initialRate)
+{
+    // Outside the window there is nothing to scratch back into yet
+    if (playhead < validStart || playhead > validEnd)
+        validStart = validEnd = playhead;
+
+    position = (double) playhead;
+    rate = initialRate;
+    targetRate = 0.0;
+    motorRate = initialRate;
+    touched = true;
+    active = true;
+}
+
+int ScratchPlayer::getSamplesWanted() const
+{
+    const int64 wanted = (int64) (position + aheadSeconds * sourceRate) - validEnd;
+    return (int) jlimit((int64) 0, (int64) maxFillPerBlock, wanted);
+}
+
+AudioSourceChannelInfo ScratchPlayer::getFillRegion(int numSamples)
+{
+    const int index = (int) (validEnd % capacity);
+    return AudioSourceChannelInfo(&ring, index, jmin(numSamples, capacity - index));
+}
+
+void ScratchPlayer::commitFill(int numSamples)
+{
+    validEnd += numSamples;
+    validStart = jmax(validStart, validEnd - capacity);
+}
+
+void ScratchPlayer::render(AudioBuffer<float>& buffer, int startSample, int numSamples, double outputSampleRate)
+{
+    const int numChannels = jmin(2, buffer.getNumChannels());
+
+    // The interpolator needs one sample before the playhead and two after it
+    const double lowest = (double) (validStart + 1);
+    const double highest = (double) (validEnd - 3);
+
+    if (highest < lowest)
+    {
+        buffer.clear(startSample, numSamples);
+        return;
+    }
+
+    const double baseStep = sourceRate / outputSampleRate;
+    const double follow = 1.0 - std::exp(-1.0 / (platterSeconds * outputSampleRate));
+    const double target = touched ? targetRate : motorRate;
+
+    const float* in[2] = { ring.getReadPointer(0), ring.getReadPointer(1) };
+    float* out[2] = { buffer.getWritePointer(0, startSample),
+                      buffer.getWritePointer(numChannels - 1, startSample) };
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        position = jlimit(lowest, highest, position);
+
+        const int64 whole = (int64) position;
+        const float t = (float) (position - (double) whole);
+
+        int i1 = (int) (whole % capacity);
+        int i0 = i1 - 1;    if (i0 < 0) i0 += capacity;
+        int i2 = i1 + 1;    if (i2 >= capacity) i2 -= capacity;
+        int i3 = i2 + 1;    if (i3 >= capacity) i3 -= capacity;
+
+        const float gain = (float) jmin(1.0, std::abs(rate) / silentRate);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float y0 = in[ch][i0], y1 = in[ch][i1], y2 = in[ch][i2], y3 = in[ch][i3];
+
+            // Catmull-Rom (4-point, 3rd-order Hermite)
+            const float c1 = 0.5f * (y2 - y0);
+            const float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+            const float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+
+            out[ch][i] = gain * (((c3 * t + c2) * t + c1) * t + y1);
+        }
+
+        rate += (target - rate) * follow;
+        position += rate * baseStep;
+    }
+
+    position = jlimit(lowest, highest, position);
+}
+
+bool ScratchPlayer::hasSettled() const
+{
+    return ! touched && std::abs(rate - motorRate) < 0.01;
+}
+
+const AudioBuffer<float>* ScratchPlayer::copyRemaining(int64& startPosition, int& length)
+{
+    startPosition = (int64) std::ceil(position);
+    const int64 remaining = validEnd - startPosition;
+
+    if (remaining < 0 || remaining > maxHandoverSamples)
+        return nullptr;
+
+    length = (int) remaining;
+
+    const int index = (int) (startPosition % capacity);
+    const int part = jmin(length, capacity - index);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        handover.copyFrom(ch, 0, ring, ch, index, part);
+        if (length > part)
+            handover.copyFrom(ch, part, ring, ch, 0, length - part);
+    }
+
+    return &handover;
+}
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    ScratchPlayer.h
+    Created: 18 Oct 2026 7:11:05pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Vinyl-style playback for scratching, from a RAM window around the playhead.
+
+    While the deck plays normally the window records what has just played, so
+    there is audio behind the playhead the moment a hand touches the platter.
+    While the platter is held the deck tops the window up from the track
+    ahead of the playhead. The platter speed is smoothed towards the jog's
+    target on every sample, can go backwards, and the audio is read with a
+    4-point Hermite interpolator, which is cheap enough for 32-sample blocks
+    and stays clean through sudden changes of direction.
+
+    All buffers are allocated in the constructor, when a track is loaded.
+*/
+class ScratchPlayer
+{
+public:
+    /** Allocate the window for a track at the given sample rate (not on the audio thread) */
+    explicit ScratchPlayer(double sourceSampleRate);
+
+    /** Record audio the deck has just played. positionAfter is the track
+        position just past its last sample (audio thread). */
+    void pushHistory(const AudioBuffer<float>& buffer, int startSample, int numSamples, int64 positionAfter);
+
+    /** Put a hand on the platter at the given track position while it spins at
+        initialRate. The hand holds the platter still until setTargetRate().
+        The window is kept if the position is inside it; the deck's reader
+        has to be parked at getEnd() afterwards. */
+    void begin(int64 playhead, double initialRate);
+    /** Put the hand back on a platter that is still scratching */
+    void touch() { touched = true; targetRate = 0.0; }
+    /** Take the hand off; the platter returns to the motor speed */
+    void release() { touched = false; }
+    /** Stop scratching; the deck plays from its reader again */
+    void end() { active = false; touched = false; }
+
+    /** Set the platter speed the jog asks for: 1 = normal, negative = backwards */
+    void setTargetRate(double rate) { targetRate = rate; }
+    /** Set the speed the motor spins the platter at when it isn't held */
+    void setMotorRate(double rate) { motorRate = rate; }
+
+    bool isActive() const  { return active; }
+    bool isTouched() const { return touched; }
+    /** Return the playhead in source samples */
+    double getPosition() const { return position; }
+    /** Return the track position the window ends at, where the reader is parked */
+    int64 getEnd() const { return validEnd; }
+    /** Return how many samples the window holds past the playhead */
+    int64 getSamplesAhead() const { return validEnd - (int64) std::ceil(position); }
+
+    /** Return how many samples to read from the track to stay far enough
+        ahead of the playhead, limited per block */
+    int getSamplesWanted() const;
+    /** Return where the next samples read from the track should go. The
+        region can be shorter than asked for where the window wraps. */
+    AudioSourceChannelInfo getFillRegion(int numSamples);
+    /** Extend the window by samples written into the last fill region */
+    void commitFill(int numSamples);
+
+    /** Render a block at the output rate, moving the playhead at the platter
+        speed on every sample (audio thread) */
+    void render(AudioBuffer<float>& buffer, int startSample, int numSamples, double outputSampleRate);
+
+    /** Check whether the platter is back at the motor speed after a release */
+    bool hasSettled() const;
+    /** Copy the audio from the playhead to the end of the window into a
+        linear buffer, for the deck to play out before its reader. Returns
+        nullptr if more than maxHandoverSamples are left. */
+    const AudioBuffer<float>* copyRemaining(int64& startPosition, int& length);
+
+    static constexpr int maxHandoverSamples = 4096;
+
+private:
+    static constexpr double windowSeconds = 16.0;
+    static constexpr double aheadSeconds = 1.0;
+    static constexpr int maxFillPerBlock = 8192;
+
+    const double sourceRate;
+    AudioBuffer<float> ring;            // track audio at position % capacity
+    AudioBuffer<float> handover;
+    int capacity = 0;
+    int64 validStart = 0, validEnd = 0;
+
+    bool active = false;
+    bool touched = false;
+    double position = 0.0;
+    double rate = 0.0;
+    double targetRate = 0.0;
+    double motorRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScratchPlayer)
+};
@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+    ScrollingWaveform.cpp
+    Created: 18 Oct 2026 9:38:47pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "ScrollingWaveform.h"
+#include "WaveformDisplay.h"
+
+namespace
+{
+    int64 floorDivide(int64 value, int64 divisor)
+    {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+}
+
+//==============================================================================
+ScrollingWaveform::ScrollingWaveform()
+    : cache(std::make_shared<TileCache>())
+{
+    setOpaque(true);
+}
+
+ScrollingWaveform::~ScrollingWaveform()
+{
+}
+
+void ScrollingWaveform::setPyramid(std::shared_ptr<WaveformPyramid> newPyramid)
+{
+    pyramid = std::move(newPyramid);
+    cache = std::make_shared<TileCache>();
+    repaint();
+}
+
+void ScrollingWaveform::resized()
+{
+    tileWidth = jmax(64, getWidth());
+    cache = std::make_shared<TileCache>();
+}
+
+void ScrollingWaveform::mouseWheelMove(const MouseEvent&, const MouseWheelDetails& wheel)
+{
+    if (wheel.deltaY == 0.0f) return;
+
+    zoom = jlimit(minZoom, maxZoom, zoom + (wheel.deltaY > 0.0f ? -1 : 1));
+    repaint();
+}
+
+void ScrollingWaveform::setPositionSeconds(double seconds)
+{
+    positionSeconds = seconds;
+
+    if (pyramid == nullptr || ! pyramid->isPrepared())
+        return;
+
+    const int64 pixel = (int64) std::floor(seconds * pyramid->getSampleRate() / (double) (1 << zoom));
+    const bool building = ! pyramid->isComplete();
+
+    // Only repaint when the view has moved a pixel or new tiles are in
+    if (cache->changed.exchange(false) || pixel != playheadPixel || building)
+        repaint();
+}
+
+void ScrollingWaveform::paint(Graphics& g)
+{
+    g.fillAll(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
+
+    const int centre = getWidth() / 2;
+
+    if (pyramid != nullptr && pyramid->isPrepared())
+    {
+        playheadPixel = (int64) std::floor(positionSeconds * pyramid->getSampleRate() / (double) (1 << zoom));
+
+        const int64 leftPixel = playheadPixel - centre;
+        const int64 firstTile = floorDivide(leftPixel, tileWidth);
+        const int64 lastTile = (pyramid->getLengthInSamples() >> zoom) / tileWidth;
+
+        // The view is never wider than a tile, so it spans two at most
+        for (int64 index = firstTile; index <= firstTile + 1; ++index)
+        {
+            if (index < 0 || index > lastTile) continue;
+
+            const auto image = getTile(index);
+            if (image.isValid())
+                g.drawImageAt(image, (int) (index * tileWidth - leftPixel), 0);
+        }
+
+        // Have the next tile ready before the playhead reaches it
+        if (firstTile + 2 <= lastTile)
+            getTile(firstTile + 2);
+    }
+
+    g.setColour(Colours::lightgreen);
+    g.fillRect(centre - 1, 0, 2, getHeight());
+
+    g.setColour(Colours::grey);
+    g.drawRect(getLocalBounds(), 1);
+}
+
+Image ScrollingWaveform::getTile(int64 index)
+{
+    const ScopedLock sl(cache->lock);
+    auto& tiles = cache->tiles;
+
+    Tile* tile = nullptr;
+    for (auto& t : tiles)
+        if (t.zoom == zoom && t.index == index)
+            tile = &t;
+
+    if (tile == nullptr)
+    {
+        // Reuse the least recently used tile that isn't being drawn
+        if ((int) tiles.size() >= maxTiles)
+            for (auto& t : tiles)
+                if (! t.pending && (tile == nullptr || t.lastUsed < tile->lastUsed))
+                    tile = &t;
+
+        if (tile == nullptr)
+            tile = &tiles.emplace_back();
+
+        *tile = Tile();
+        tile->zoom = zoom;
+        tile->index = index;
+        requestTile(*tile);
+    }
+    else if (! tile->pending && ! tile->complete && pyramid->getSamplesReady() > tile->samplesReady)
+    {
+        requestTile(*tile);
+    }
+
+    tile->lastUsed = ++cache->useCounter;
+    return tile->image;
+}
+
+void ScrollingWaveform::requestTile(Tile& tile)
+{
+    tile.pending = true;
+
+    renderPool->addJob([tileCache = cache, builder = pyramid, tileZoom = zoom, index = tile.index,
+                        width = tileWidth, height = jmax(1, getHeight())]
+    {
+        const double samplesPerPixel = (double) (1 << tileZoom);
+        const int64 firstSample = index * width * (int64) samplesPerPixel;
+        const int64 endSample = firstSample + width * (int64) samplesPerPixel;
+
+        // Read before drawing, so a tile is never marked newer than its data
+        const int64 ready = builder->getSamplesReady();
+        const bool complete = builder->isComplete() || ready >= endSample;
+
+        Image image(Image::ARGB, width, height, true, SoftwareImageType());
+        {
+            Graphics g(image);
+            WaveformDisplay::drawWaveform(g, *builder, (double) firstSample, samplesPerPixel, image.getBounds());
+        }
+
+        const ScopedLock sl(tileCache->lock);
+
+        for (auto& t : tileCache->tiles)
+        {
+            if (t.zoom == tileZoom && t.index == index && t.pending)
+            {
+                t.image = image;
+                t.pending = false;
+                t.complete = complete;
+                t.samplesReady = ready;
+                tileCache->changed.store(true);
+                break;
+            }
+        }
+    });
+}
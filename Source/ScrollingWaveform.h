@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    ScrollingWaveform.h
+    Created: 18 Oct 2026 9:38:47pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "WaveformPyramid.h"
+
+//==============================================================================
+/** A zoomed waveform that scrolls past a fixed playhead in the middle.
+
+    The waveform is cut into tiles as wide as the component, drawn into
+    Images on a background thread and kept in a small LRU cache, so a frame
+    only blits the two tiles under the view and draws the playhead. The
+    mouse wheel zooms in and out in powers of two; tiles for each zoom
+    level stay cached, so zooming back is instant.
+
+    The owner moves the playhead once per display frame; a frame in which
+    it hasn't moved a whole pixel, and no tiles have come in, draws nothing.
+*/
+class ScrollingWaveform : public Component
+{
+public:
+    ScrollingWaveform();
+    ~ScrollingWaveform() override;
+
+    /** Blit the tiles under the view and draw the playhead */
+    void paint(Graphics& g) override;
+    /** Drop the tiles, which are cut to the component's size */
+    void resized() override;
+
+    /** Zoom in or out by a power of two */
+    void mouseWheelMove(const MouseEvent& e, const MouseWheelDetails& wheel) override;
+
+    /** Show a track's waveform, or nothing if pyramid is null */
+    void setPyramid(std::shared_ptr<WaveformPyramid> pyramid);
+
+    /** Move the playhead to a position in seconds, once per display frame */
+    void setPositionSeconds(double seconds);
+
+private:
+    struct Tile
+    {
+        int zoom = 0;
+        int64 index = 0;
+        Image image;
+        bool pending = false;       // queued on the render thread
+        bool complete = false;      // drawn from finished buckets only
+        int64 samplesReady = 0;     // how much of the track was built when it was drawn
+        uint32 lastUsed = 0;
+    };
+
+    /** The tiles, shared with the render jobs. Replaced rather than cleared,
+        so a job still running for old tiles can't put them back. */
+    struct TileCache
+    {
+        CriticalSection lock;
+        std::vector<Tile> tiles;
+        uint32 useCounter = 0;
+        std::atomic<bool> changed { false };
+    };
+
+    /** Background thread shared by every scrolling waveform */
+    struct RenderPool : public ThreadPool
+    {
+        RenderPool() : ThreadPool(1) {}
+    };
+
+    /** Return a tile's image if it has been drawn, queueing it if it hasn't
+        or the track has been built further since */
+    Image getTile(int64 index);
+    void requestTile(Tile& tile);
+
+    static constexpr int maxTiles = 16;
+    static constexpr int minZoom = 4;       // 16 samples per pixel
+    static constexpr int maxZoom = 12;      // 4096 samples per pixel
+
+    std::shared_ptr<WaveformPyramid> pyramid;
+    std::shared_ptr<TileCache> cache;
+    int zoom = 9;                           // log2 of the samples per pixel
+    int tileWidth = 256;
+    double positionSeconds = 0.0;
+    int64 playheadPixel = 0;                // where the playhead was last drawn
+
+    SharedResourcePointer<RenderPool> renderPool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScrollingWaveform)
+};
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    SeqLockSnapshot.h
+    Created: 18 Oct 2026 2:05:19pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+/** Publishes a small, trivially copyable struct from one writer thread to any
+    number of readers without locks.
+
+    The writer (normally the audio thread) never waits. A reader that races
+    with a write simply retries, so reads are only as expensive as the copy.
+*/
+template <typename T>
+class SeqLockSnapshot
+{
+public:
+    static_assert (std::is_trivially_copyable<T>::value, "SeqLockSnapshot needs a trivially copyable type");
+
+    SeqLockSnapshot()
+    {
+        publish (T{});
+    }
+
+    /** Store a new value (single writer only) */
+    void publish (const T& value) noexcept
+    {
+        std::array<uint64, numWords> raw {};
+        std::memcpy (raw.data(), &value, sizeof (T));
+
+        const auto seq = sequence.load (std::memory_order_relaxed);
+        sequence.store (seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+
+        for (size_t i = 0; i < numWords; ++i)
+            words[i].store (raw[i], std::memory_order_relaxed);
+
+        sequence.store (seq + 2, std::memory_order_release);
+    }
+
+    /** Return the most recently published value */
+    T read() const noexcept
+    {
+        std::array<uint64, numWords> raw {};
+
+        for (;;)
+        {
+            const auto before = sequence.load (std::memory_order_acquire);
+
+            if ((before & 1u) != 0)
+                continue; // a write is in progress
+
+            for (size_t i = 0; i < numWords; ++i)
+                raw[i] = words[i].load (std::memory_order_relaxed);
+
+            std::atomic_thread_fence (std::memory_order_acquire);
+
+            if (sequence.load (std::memory_order_relaxed) == before)
+                break;
+        }
+
+        T value;
+        std::memcpy (&value, raw.data(), sizeof (T));
+        return value;
+    }
+
+private:
+    static constexpr size_t numWords = (sizeof (T) + sizeof (uint64) - 1) / sizeof (uint64);
+
+    std::atomic<uint32> sequence { 0 };
+    std::array<std::atomic<uint64>, numWords> words {};
+
+    JUCE_DECLARE_NON_COPYABLE (SeqLockSnapshot)
+};
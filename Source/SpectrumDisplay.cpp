@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    SpectrumDisplay.cpp
+    Created: 18 Oct 2026 11:02:44pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "SpectrumDisplay.h"
+
+//==============================================================================
+SpectrumDisplay::SpectrumDisplay(SpectrumSource& sourceToShow)
+    : source(sourceToShow)
+{
+    setOpaque(true);
+    startTimerHz(30);
+}
+
+SpectrumDisplay::~SpectrumDisplay()
+{
+    stopTimer();
+}
+
+void SpectrumDisplay::resized()
+{
+    spectrogram = Image(Image::RGB, jmax(1, getWidth() - stripWidth), SpectrumSource::numBands, true);
+}
+
+void SpectrumDisplay::mouseUp(const MouseEvent&)
+{
+    source.setEnabled(! source.isEnabled());
+    spectrogram.clear(spectrogram.getBounds());
+    repaint();
+}
+
+Colour SpectrumDisplay::getLevelColour(float level)
+{
+    // Dark blue through green to yellow as the level rises
+    return Colour::fromHSV(0.66f - 0.5f * level, 0.9f, jmin(1.0f, level * 1.4f), 1.0f);
+}
+
+void SpectrumDisplay::timerCallback()
+{
+    if (! source.isEnabled() || ! spectrogram.isValid())
+        return;
+
+    const auto spectrum = source.getSpectrum();
+    if (spectrum.frame == shown.frame)
+        return;
+
+    shown = spectrum;
+
+    // Scroll the spectrogram one column left and draw the newest on the right
+    const int width = spectrogram.getWidth();
+    spectrogram.moveImageSection(0, 0, 1, 0, width - 1, SpectrumSource::numBands);
+
+    {
+        Image::BitmapData column(spectrogram, width - 1, 0, 1, SpectrumSource::numBands,
+                                 Image::BitmapData::writeOnly);
+
+        for (int band = 0; band < SpectrumSource::numBands; ++band)
+            column.setPixelColour(0, SpectrumSource::numBands - 1 - band,
+                                  getLevelColour(shown.levels[(size_t) band]));
+    }
+
+    repaint();
+}
+
+void SpectrumDisplay::paint(Graphics& g)
+{
+    g.fillAll(Colour(20, 22, 25));
+
+    if (! source.isEnabled())
+    {
+        g.setColour(Colours::grey);
+        g.setFont(12.0f);
+        g.drawText("SPECTRUM OFF - click to analyse", getLocalBounds(), Justification::centred, true);
+    }
+    else
+    {
+        auto area = getLocalBounds();
+        const auto strip = area.removeFromRight(stripWidth).toFloat();
+
+        g.setImageResamplingQuality(Graphics::lowResamplingQuality);
+        g.drawImage(spectrogram, area.toFloat());
+
+        // One bar per band, growing left to right
+        const float rowHeight = strip.getHeight() / SpectrumSource::numBands;
+
+        for (int band = 0; band < SpectrumSource::numBands; ++band)
+        {
+            const float level = shown.levels[(size_t) band];
+            const float y = strip.getBottom() - (band + 1) * rowHeight;
+
+            g.setColour(getLevelColour(level));
+            g.fillRect(strip.getX(), y, strip.getWidth() * level, rowHeight);
+        }
+    }
+
+    g.setColour(Colour(60, 65, 70));
+    g.drawRect(getLocalBounds(), 1);
+}
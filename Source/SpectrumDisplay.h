@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    SpectrumDisplay.h
+    Created: 18 Oct 2026 11:02:44pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SpectrumSource.h"
+
+//==============================================================================
+/** A spectrogram with the current spectrum beside it, polling a
+    SpectrumSource.
+
+    Frequency runs up the display from 30 Hz to 20 kHz on a log scale. The
+    spectrogram scrolls left with one new column per update, and the strip
+    on the right shows the level of each band now. The analyser is off
+    until the display is clicked, and a second click turns it off again.
+*/
+class SpectrumDisplay : public Component,
+                        private Timer
+{
+public:
+    /** Create a display for the given source, which must outlive it */
+    explicit SpectrumDisplay(SpectrumSource& sourceToShow);
+    ~SpectrumDisplay() override;
+
+    /** Draw the spectrogram and the current spectrum */
+    void paint(Graphics& g) override;
+    /** Start a new spectrogram at the new width */
+    void resized() override;
+
+    /** Turn the analyser on or off */
+    void mouseUp(const MouseEvent& e) override;
+
+private:
+    void timerCallback() override;
+    static Colour getLevelColour(float level);
+
+    static constexpr int stripWidth = 24;
+
+    SpectrumSource& source;
+    SpectrumSource::Spectrum shown;
+    Image spectrogram;      // one row per band, lowest at the bottom
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumDisplay)
+};
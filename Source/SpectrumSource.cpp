@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    SpectrumSource.cpp
+    Created: 18 Oct 2026 11:02:44pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "SpectrumSource.h"
+
+namespace
+{
+    constexpr double lowestHz = 30.0;
+    constexpr double highestHz = 20000.0;
+
+    // How far a band's hold falls per frame, in the 0..1 level scale
+    constexpr float fallPerFrame = 0.015f;
+}
+
+SpectrumSource::SpectrumSource()
+    : window((size_t) fftSize),
+      history((size_t) fftSize, 0.0f),
+      fftData((size_t) fftSize * 2, 0.0f)
+{
+    dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t) fftSize,
+                                                       dsp::WindowingFunction<float>::hann, false);
+    prepare(44100.0);
+    thread->addTimeSliceClient(this);
+}
+
+SpectrumSource::~SpectrumSource()
+{
+    thread->removeTimeSliceClient(this);
+}
+
+void SpectrumSource::prepare(double sampleRate)
+{
+    const ScopedLock sl(analysisLock);
+
+    fifo.reset();
+    std::fill(history.begin(), history.end(), 0.0f);
+    current = Spectrum();
+    spectrum.publish(current);
+
+    // Log-spaced bands, each at least one bin wide
+    const double top = jmin(highestHz, sampleRate * 0.5);
+    const int maxBin = fftSize / 2;
+
+    for (int band = 0; band <= numBands; ++band)
+    {
+        const double hz = lowestHz * std::pow(top / lowestHz, (double) band / numBands);
+        int bin = jlimit(1, maxBin, roundToInt(hz * fftSize / sampleRate));
+
+        if (band > 0)
+            bin = jmin(maxBin, jmax(bin, bandEdges[(size_t) band - 1] + 1));
+
+        bandEdges[(size_t) band] = bin;
+    }
+}
+
+void SpectrumSource::push(const AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (! enabled.load(std::memory_order_relaxed) || buffer.getNumChannels() == 0)
+        return;
+
+    // Whatever doesn't fit is dropped; the analyser catches up on later blocks
+    const auto scope = fifo.write(numSamples);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const int source = jmin(ch, buffer.getNumChannels() - 1);
+
+        if (scope.blockSize1 > 0)
+            fifoBuffer.copyFrom(ch, scope.startIndex1, buffer, source, startSample, scope.blockSize1);
+        if (scope.blockSize2 > 0)
+            fifoBuffer.copyFrom(ch, scope.startIndex2, buffer, source, startSample + scope.blockSize1, scope.blockSize2);
+    }
+}
+
+int SpectrumSource::useTimeSlice()
+{
+    const ScopedLock sl(analysisLock);
+
+    if (! enabled.load())
+    {
+        // Throw away anything pushed just before the analyser was turned off
+        const auto scope = fifo.read(fifo.getNumReady());
+        ignoreUnused(scope);
+        return 50;
+    }
+
+    while (fifo.getNumReady() >= hopSize)
+    {
+        // Slide the window along by one hop and append the new audio as mono
+        std::copy(history.begin() + hopSize, history.end(), history.begin());
+        float* tail = history.data() + (fftSize - hopSize);
+
+        const auto scope = fifo.read(hopSize);
+        int done = 0;
+
+        auto append = [&](int start, int size)
+        {
+            if (size <= 0) return;
+
+            FloatVectorOperations::copy(tail + done, fifoBuffer.getReadPointer(0, start), size);
+            FloatVectorOperations::add(tail + done, fifoBuffer.getReadPointer(1, start), size);
+            FloatVectorOperations::multiply(tail + done, 0.5f, size);
+            done += size;
+        };
+
+        append(scope.startIndex1, scope.blockSize1);
+        append(scope.startIndex2, scope.blockSize2);
+
+        analyseFrame();
+    }
+
+    return 10;
+}
+
+void SpectrumSource::analyseFrame()
+{
+    FloatVectorOperations::multiply(fftData.data(), history.data(), window.data(), fftSize);
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // A full-scale sine peaks at fftSize / 4 through a Hann window
+    const float scale = 4.0f / (float) fftSize;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const int first = bandEdges[(size_t) band];
+        const int last = jmax(first + 1, bandEdges[(size_t) band + 1]);
+
+        float peak = 0.0f;
+        for (int bin = first; bin < last && bin <= fftSize / 2; ++bin)
+            peak = jmax(peak, fftData[(size_t) bin]);
+
+        const float db = Decibels::gainToDecibels(peak * scale, floorDb);
+        const float level = jlimit(0.0f, 1.0f, 1.0f - db / floorDb);
+
+        auto& shown = current.levels[(size_t) band];
+        shown = jmax(level, shown - fallPerFrame);
+    }
+
+    ++current.frame;
+    spectrum.publish(current);
+}
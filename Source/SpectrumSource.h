@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    SpectrumSource.h
+    Created: 18 Oct 2026 11:02:44pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+#include "SeqLockSnapshot.h"
+
+/** Feeds a spectrum analyser from the audio thread without slowing it down.
+
+    The audio thread only copies each block into a wait-free FIFO (one copy
+    per channel, nothing at all while the analyser is off). A background
+    thread shared by every source takes the audio from there, runs a
+    Hann-windowed FFT every 512 samples, folds the bins into log-spaced
+    bands and publishes them, with a falling hold, for the GUI to draw.
+    If the analysis falls behind, the FIFO drops audio rather than block.
+*/
+class SpectrumSource : private TimeSliceClient
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = 512;
+    static constexpr int numBands = 96;     // 30 Hz to 20 kHz
+    static constexpr float floorDb = -90.0f;
+
+    struct Spectrum
+    {
+        std::array<float, numBands> levels {};  // 0 = floorDb or below, 1 = 0 dBFS
+        uint32 frame = 0;                       // counts the frames analysed
+    };
+
+    SpectrumSource();
+    ~SpectrumSource() override;
+
+    /** Reset the analyser for a new sample rate (not while pushing) */
+    void prepare(double sampleRate);
+
+    /** Copy a block into the FIFO if the analyser is on (audio thread) */
+    void push(const AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    /** Turn the analyser on or off (any thread) */
+    void setEnabled(bool shouldBeEnabled) { enabled.store(shouldBeEnabled); }
+    /** Check whether the analyser is on */
+    bool isEnabled() const { return enabled.load(); }
+
+    /** Read the latest bands (any thread, lock-free) */
+    Spectrum getSpectrum() const { return spectrum.read(); }
+
+private:
+    int useTimeSlice() override;
+    void analyseFrame();
+
+    /** Background thread shared by every spectrum source */
+    struct AnalysisThread : public TimeSliceThread
+    {
+        AnalysisThread() : TimeSliceThread("Spectrum analysis") { startThread(Thread::Priority::low); }
+        ~AnalysisThread() override { stopThread(2000); }
+    };
+
+    static constexpr int fifoSize = 16384;
+
+    std::atomic<bool> enabled { false };
+    AbstractFifo fifo { fifoSize };
+    AudioBuffer<float> fifoBuffer { 2, fifoSize };
+
+    // Analysis state, only touched under analysisLock by the analysis
+    // thread or by prepare()
+    CriticalSection analysisLock;
+    dsp::FFT fft { fftOrder };
+    std::vector<float> window;
+    std::vector<float> history;             // the last fftSize samples, mono
+    std::vector<float> fftData;             // 2 * fftSize, as dsp::FFT needs
+    std::array<int, numBands + 1> bandEdges {};
+    Spectrum current;
+
+    SeqLockSnapshot<Spectrum> spectrum;
+    SharedResourcePointer<AnalysisThread> thread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumSource)
+};
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    TrackPreview.cpp
+    Created: 18 Oct 2026 11:41:27pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "TrackPreview.h"
+
+namespace
+{
+    constexpr int chunkSamples = 32768;
+
+    uint8 toByte(float level)
+    {
+        return (uint8) jlimit(0, 255, roundToInt(level * 255.0f));
+    }
+}
+
+bool TrackPreview::createFrom(const WaveformPyramid& pyramid)
+{
+    if (! pyramid.isComplete() || pyramid.getLengthInSamples() <= 0)
+        return false;
+
+    const int64 length = pyramid.getLengthInSamples();
+    const int level = pyramid.getLevelFor((double) length / numColumns);
+
+    for (int col = 0; col < numColumns; ++col)
+    {
+        WaveformPyramid::Summary summary;
+        const int64 start = length * col / numColumns;
+        const int64 end = jmax(start + 1, length * (col + 1) / numColumns);
+
+        if (! pyramid.getSummary(level, start, end, summary))
+            return false;
+
+        peaks[(size_t) col] = toByte(jmax(std::abs(summary.min), std::abs(summary.max)));
+        rms[(size_t) col] = toByte(summary.rms);
+    }
+
+    return true;
+}
+
+bool TrackPreview::createFrom(AudioFormatReader& reader, const std::function<bool()>& shouldExit)
+{
+    const int64 length = reader.lengthInSamples;
+    const int numChannels = jlimit(1, 2, (int) reader.numChannels);
+
+    if (length <= 0)
+        return false;
+
+    AudioBuffer<float> buffer(numChannels, chunkSamples);
+    int64 position = 0;
+
+    for (int col = 0; col < numColumns; ++col)
+    {
+        const int64 end = jmax(position, length * (col + 1) / numColumns);
+        const int64 count = end - position;
+        float peak = 0.0f;
+        double sumOfSquares = 0.0;
+
+        while (position < end)
+        {
+            if (shouldExit != nullptr && shouldExit())
+                return false;
+
+            const int num = (int) jmin((int64) chunkSamples, end - position);
+            reader.read(&buffer, 0, num, position, true, numChannels > 1);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                peak = jmax(peak, buffer.getMagnitude(ch, 0, num));
+                sumOfSquares += (double) square(buffer.getRMSLevel(ch, 0, num)) * num;
+            }
+
+            position += num;
+        }
+
+        peaks[(size_t) col] = toByte(peak);
+        rms[(size_t) col] = count > 0 ? toByte((float) std::sqrt(sumOfSquares / (double) (count * numChannels)))
+                                      : (uint8) 0;
+    }
+
+    return true;
+}
+
+String TrackPreview::toBase64() const
+{
+    MemoryBlock block((size_t) numBytes);
+    block.copyFrom(peaks.data(), 0, (size_t) numColumns);
+    block.copyFrom(rms.data(), numColumns, (size_t) numColumns);
+    return block.toBase64Encoding();
+}
+
+bool TrackPreview::fromBase64(const String& text)
+{
+    MemoryBlock block;
+    if (text.isEmpty() || ! block.fromBase64Encoding(text) || block.getSize() != (size_t) numBytes)
+        return false;
+
+    block.copyTo(peaks.data(), 0, (size_t) numColumns);
+    block.copyTo(rms.data(), numColumns, (size_t) numColumns);
+    return true;
+}
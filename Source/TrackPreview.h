@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+    TrackPreview.h
+    Created: 18 Oct 2026 11:41:27pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "WaveformPyramid.h"
+
+/** A miniature waveform of a whole track, small enough to keep with every
+    library entry: the peak and the RMS level of 128 equal stretches of the
+    track, a byte each, 256 bytes in all.
+
+    Previews are made on a background thread, from the waveform cache when
+    the track has been on a deck before and by decoding it otherwise, and
+    are then only ever read, so drawing one costs no more than drawing the
+    text beside it.
+*/
+struct TrackPreview
+{
+    static constexpr int numColumns = 128;
+    static constexpr int numBytes = numColumns * 2;
+
+    std::array<uint8, numColumns> peaks {};     // 0 = silence, 255 = full scale
+    std::array<uint8, numColumns> rms {};
+
+    /** Summarise a complete waveform. Returns false if it isn't complete. */
+    bool createFrom(const WaveformPyramid& pyramid);
+    /** Decode a whole track into the preview (background thread). Returns
+        false if the track is empty or shouldExit() asked it to stop. */
+    bool createFrom(AudioFormatReader& reader, const std::function<bool()>& shouldExit);
+
+    /** Pack the preview for the library file, and unpack it */
+    String toBase64() const;
+    bool fromBase64(const String& text);
+};
@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    WaveformCache.cpp
+    Created: 18 Oct 2026 10:26:03pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "WaveformCache.h"
+#include <algorithm>
+
+namespace
+{
+    // How much of each end of a file goes into its key
+    constexpr int hashedBytes = 64 * 1024;
+
+    constexpr int64 defaultQuotaBytes = (int64) 512 * 1024 * 1024;
+
+    /** 64-bit FNV-1a */
+    uint64 hashBytes(const void* data, size_t numBytes, uint64 hash)
+    {
+        const auto* bytes = static_cast<const uint8*>(data);
+
+        for (size_t i = 0; i < numBytes; ++i)
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+
+        return hash;
+    }
+}
+
+//==============================================================================
+WaveformCache::WaveformCache()
+    : WaveformCache(File::getSpecialLocation(File::userApplicationDataDirectory)
+                        .getChildFile("Otodecks").getChildFile("waveforms"),
+                    defaultQuotaBytes)
+{
+}
+
+WaveformCache::WaveformCache(const File& directoryToUse, int64 quota)
+    : directory(directoryToUse),
+      quotaBytes(quota)
+{
+}
+
+File WaveformCache::getCacheFile(const File& audioFile) const
+{
+    FileInputStream in(audioFile);
+    if (in.failedToOpen())
+        return {};
+
+    const int64 size = in.getTotalLength();
+    HeapBlock<char> buffer(hashedBytes);
+    uint64 hash = 0xcbf29ce484222325ull;
+
+    // The start and the end of the file; for a short file that is all of it
+    hash = hashBytes(buffer, (size_t) in.read(buffer, hashedBytes), hash);
+
+    if (size > hashedBytes)
+    {
+        in.setPosition(jmax((int64) hashedBytes, size - hashedBytes));
+        hash = hashBytes(buffer, (size_t) in.read(buffer, hashedBytes), hash);
+    }
+
+    const int64 modified = audioFile.getLastModificationTime().toMilliseconds();
+
+    return directory.getChildFile(String::toHexString((int64) hash) + "-"
+                                  + String::toHexString(size) + "-"
+                                  + String::toHexString(modified) + ".wave");
+}
+
+std::shared_ptr<WaveformPyramid> WaveformCache::find(const File& audioFile)
+{
+    const auto file = getCacheFile(audioFile);
+    if (! file.existsAsFile())
+        return nullptr;
+
+    auto pyramid = std::make_shared<WaveformPyramid>();
+    if (! pyramid->loadFrom(file))
+    {
+        file.deleteFile();
+        return nullptr;
+    }
+
+    // Mark it as recently used, so the quota takes older waveforms first
+    file.setLastAccessTime(Time::getCurrentTime());
+    return pyramid;
+}
+
+void WaveformCache::store(const File& audioFile, const WaveformPyramid& pyramid)
+{
+    const auto file = getCacheFile(audioFile);
+    if (file == File())
+        return;
+
+    const ScopedLock sl(writeLock);
+
+    if (! directory.isDirectory())
+        directory.createDirectory();
+
+    if (pyramid.writeTo(file))
+        trimToQuota();
+}
+
+void WaveformCache::trimToQuota()
+{
+    auto files = directory.findChildFiles(File::findFiles, false, "*.wave");
+
+    int64 total = 0;
+    for (const auto& f : files)
+        total += f.getSize();
+
+    if (total <= quotaBytes)
+        return;
+
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b)
+    {
+        return jmax(a.getLastAccessTime(), a.getLastModificationTime())
+             < jmax(b.getLastAccessTime(), b.getLastModificationTime());
+    });
+
+    for (const auto& f : files)
+    {
+        if (total <= quotaBytes)
+            break;
+
+        const int64 size = f.getSize();
+        if (f.deleteFile())
+            total -= size;
+    }
+}
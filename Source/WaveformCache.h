@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    WaveformCache.h
+    Created: 18 Oct 2026 10:26:03pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include "WaveformPyramid.h"
+
+/** Keeps built waveforms on disk, so a track seen before shows its whole
+    waveform straight away instead of being decoded again.
+
+    Each track is stored under the Otodecks app-data directory in a file
+    named after a hash of its first and last 64 KB, its size and its
+    modification time, so an edited or replaced file is never matched to
+    an old waveform. Files are memory-mapped when loaded, so only the parts
+    of a waveform that are drawn are ever read from disk. Once the cache
+    grows past its quota, the least recently used waveforms are deleted.
+*/
+class WaveformCache
+{
+public:
+    /** Create a cache in the default directory with a 512 MB quota */
+    WaveformCache();
+    WaveformCache(const File& directory, int64 quotaBytes);
+
+    /** Return the saved waveform of an audio file, or nullptr if there is none */
+    std::shared_ptr<WaveformPyramid> find(const File& audioFile);
+    /** Save a complete waveform for an audio file, then trim the cache to its quota */
+    void store(const File& audioFile, const WaveformPyramid& pyramid);
+
+private:
+    File getCacheFile(const File& audioFile) const;
+    void trimToQuota();
+
+    const File directory;
+    const int64 quotaBytes;
+
+    // store() may be called from several builder threads at once
+    CriticalSection writeLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformCache)
+};
@@ -10,72 +10,249 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "WaveformDisplay.h"
 
+namespace
+{
+    // Closest zoom, in samples per pixel
+    constexpr double minSamplesPerPixel = 16.0;
+}
+
 //==============================================================================
-WaveformDisplay::WaveformDisplay(AudioFormatManager& formatManagerToUse,
-                                 AudioThumbnailCache& cacheToUse)
-    : audioThumb(1000, formatManagerToUse, cacheToUse),
+WaveformDisplay::WaveformDisplay(AudioFormatManager& formatManagerToUse)
+    : formatManager(formatManagerToUse),
       fileLoaded(false),
       position(0)
 {
-    audioThumb.addChangeListener(this);
+    setOpaque(true);
 }
 
 WaveformDisplay::~WaveformDisplay()
 {
+    if (pyramid != nullptr)
+        pyramid->cancel();
 }
 
 void WaveformDisplay::paint(Graphics& g)
 {
-    g.fillAll(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
 
-    g.setColour(Colours::grey);
-    g.drawRect(getLocalBounds(), 1);
-
-    g.setColour(Colours::orange);
-    if (fileLoaded)
+    // Redraw the static layer only when it has been dropped or the display
+    // has moved to a screen with a different scale
+    if (! waveformLayer.isValid()
+        || waveformLayer.getWidth() != roundToInt(getWidth() * scale))
     {
-        audioThumb.drawChannel(g,
-            getLocalBounds(),
-            0,
-            audioThumb.getTotalLength(),
-            0,
-            1.0f);
+        waveformLayer = Image(Image::RGB, jmax(1, roundToInt(getWidth() * scale)),
+                              jmax(1, roundToInt(getHeight() * scale)), false);
 
-        g.setColour(Colours::lightgreen);
-        g.drawRect(position * getWidth(), 0, getWidth() / 20, getHeight());
+        Graphics lg(waveformLayer);
+        lg.addTransform(AffineTransform::scale(scale));
+
+        lg.fillAll(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));
+
+        lg.setColour(Colours::grey);
+        lg.drawRect(getLocalBounds(), 1);
+
+        lg.setColour(Colours::orange);
+        if (fileLoaded && pyramid != nullptr && pyramid->isPrepared())
+        {
+            const double length = (double) pyramid->getLengthInSamples();
+            const double samplesPerPixel = visibleRange.getLength() * length / jmax(1, getWidth());
+
+            drawWaveform(lg, *pyramid, visibleRange.getStart() * length, samplesPerPixel, getLocalBounds());
+        }
+        else if (! fileLoaded || (pyramid != nullptr && pyramid->hasFailed()))
+        {
+            lg.setFont(20.0f);
+            lg.drawText("File not loaded...", getLocalBounds(),
+                        Justification::centred, true);
+        }
     }
-    else
+
+    g.drawImage(waveformLayer, getLocalBounds().toFloat());
+
+    const auto playhead = getPlayheadArea();
+    if (! playhead.isEmpty())
     {
-        g.setFont(20.0f);
-        g.drawText("File not loaded...", getLocalBounds(),
-                    Justification::centred, true);
+        g.setColour(Colours::lightgreen);
+        g.drawRect(playhead);
     }
 }
 
 void WaveformDisplay::resized()
 {
+    waveformLayer = Image();
+}
+
+void WaveformDisplay::invalidateLayer()
+{
+    waveformLayer = Image();
+    repaint();
+}
+
+Rectangle<int> WaveformDisplay::getPlayheadArea() const
+{
+    if (! fileLoaded || pyramid == nullptr || ! pyramid->isPrepared() || ! visibleRange.contains(position))
+        return {};
+
+    const double x = (position - visibleRange.getStart()) / visibleRange.getLength() * getWidth();
+    return Rectangle<float>((float) x, 0.0f, (float) (getWidth() / 20), (float) getHeight())
+               .getSmallestIntegerContainer();
+}
+
+Colour WaveformDisplay::getBandColour(const WaveformPyramid::Summary& summary)
+{
+    // Red for the lows, green for the mids and blue for the highs. The
+    // highs carry far less energy than a kick, so they are lifted to show.
+    const float red = summary.bands[WaveformPyramid::low];
+    const float green = summary.bands[WaveformPyramid::mid] * 1.5f;
+    const float blue = summary.bands[WaveformPyramid::high] * 3.0f;
+    const float strongest = jmax(red, green, blue, 1.0e-4f);
+
+    return Colour::fromFloatRGBA(red / strongest, green / strongest, blue / strongest, 1.0f);
+}
+
+void WaveformDisplay::drawWaveform(Graphics& g, const WaveformPyramid& pyramid,
+                                   double firstSample, double samplesPerPixel, Rectangle<int> area)
+{
+    if (! pyramid.isPrepared())
+        return;
+
+    const int level = pyramid.getLevelFor(samplesPerPixel);
+    const float mid = area.getY() + area.getHeight() * 0.5f;
+    const float halfHeight = area.getHeight() * 0.5f;
+    WaveformPyramid::Summary summary;
+
+    // One column per pixel, each read from one or two buckets
+    for (int x = 0; x < area.getWidth(); ++x)
+    {
+        const double start = firstSample + x * samplesPerPixel;
+        if (start < 0.0 || ! pyramid.getSummary(level, (int64) start, (int64) (start + samplesPerPixel), summary))
+            continue;
+
+        const Colour colour = getBandColour(summary);
+
+        g.setColour(colour.withAlpha(0.55f));
+        g.drawVerticalLine(area.getX() + x, mid - summary.max * halfHeight, mid - summary.min * halfHeight + 1.0f);
+
+        g.setColour(colour);
+        g.drawVerticalLine(area.getX() + x, mid - summary.rms * halfHeight, mid + summary.rms * halfHeight + 1.0f);
+    }
+}
+
+void WaveformDisplay::mouseWheelMove(const MouseEvent& e, const MouseWheelDetails& wheel)
+{
+    if (pyramid == nullptr || ! pyramid->isPrepared() || getWidth() <= 0)
+        return;
+
+    const double length = (double) pyramid->getLengthInSamples();
+    const double narrowest = jmin(1.0, minSamplesPerPixel * getWidth() / length);
+    const double width = jlimit(narrowest, 1.0, visibleRange.getLength() * std::pow(2.0, -wheel.deltaY * 4.0));
+
+    // Keep the point under the mouse where it is
+    const double proportion = jlimit(0.0, 1.0, (double) e.position.x / getWidth());
+    const double anchor = visibleRange.getStart() + proportion * visibleRange.getLength();
+
+    visibleRange = Range<double>(0.0, 1.0).constrainRange(Range<double>::withStartAndLength(anchor - proportion * width, width));
+    invalidateLayer();
 }
 
 void WaveformDisplay::loadURL(URL audioURL)
 {
-    audioThumb.clear();
-    fileLoaded = audioThumb.setSource(new URLInputSource(audioURL));
-    if (fileLoaded)
+    // A track seen before is mapped from the disk cache and shown whole
+    if (audioURL.isLocalFile())
     {
-        repaint();
+        if (auto cached = waveformCache->find(audioURL.getLocalFile()))
+        {
+            setPyramid(std::move(cached));
+            return;
+        }
     }
+
+    if (pyramid != nullptr)
+        pyramid->cancel();
+
+    pyramid = std::make_shared<WaveformPyramid>();
+    fileLoaded = true;
+    visibleRange = { 0.0, 1.0 };
+
+    builderPool->addJob([audioURL, &manager = formatManager, builder = pyramid, cache = waveformCache]
+    {
+        std::unique_ptr<AudioFormatReader> reader;
+        if (auto stream = audioURL.createInputStream(false))
+            reader.reset(manager.createReaderFor(std::move(stream)));
+
+        if (builder->build(reader.get()) && audioURL.isLocalFile())
+            cache->store(audioURL.getLocalFile(), *builder);
+    });
+
+    startTimerHz(10);
+    invalidateLayer();
 }
 
-void WaveformDisplay::changeListenerCallback(ChangeBroadcaster* source)
+void WaveformDisplay::setPyramid(std::shared_ptr<WaveformPyramid> newPyramid)
 {
-    repaint();
+    if (pyramid != nullptr && pyramid != newPyramid)
+        pyramid->cancel();
+
+    pyramid = std::move(newPyramid);
+    fileLoaded = pyramid != nullptr;
+    visibleRange = { 0.0, 1.0 };
+
+    if (fileLoaded)
+        startTimerHz(10);
+
+    invalidateLayer();
+}
+
+std::shared_ptr<WaveformPyramid> WaveformDisplay::takePyramid()
+{
+    auto taken = std::move(pyramid);
+    pyramid.reset();
+    fileLoaded = false;
+    stopTimer();
+    invalidateLayer();
+    return taken;
+}
+
+void WaveformDisplay::clear()
+{
+    if (pyramid != nullptr)
+        pyramid->cancel();
+
+    pyramid.reset();
+    fileLoaded = false;
+    stopTimer();
+    invalidateLayer();
+}
+
+void WaveformDisplay::timerCallback()
+{
+    invalidateLayer();
+
+    if (pyramid == nullptr || pyramid->isComplete() || pyramid->hasFailed())
+        stopTimer();
 }
 
 void WaveformDisplay::setPositionRelative(double pos)
 {
     if (pos != position)
     {
+        const auto oldArea = getPlayheadArea();
         position = pos;
-        repaint();
+
+        // Page along to keep the playhead on screen while zoomed in
+        if (! visibleRange.contains(position) && visibleRange.getLength() < 1.0)
+        {
+            visibleRange = Range<double>(0.0, 1.0).constrainRange(visibleRange.movedToStartAt(position));
+            invalidateLayer();
+            return;
+        }
+
+        // Only the strips the playhead leaves and enters need drawing again
+        const auto newArea = getPlayheadArea();
+        if (newArea != oldArea)
+        {
+            repaint(oldArea);
+            repaint(newArea);
+        }
     }
 }
@@ -10,36 +10,84 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include <memory>
+#include "WaveformCache.h"
+#include "WaveformPyramid.h"
 
 //==============================================================================
-/*
+/** Draws a track's waveform from a WaveformPyramid, so zooming and scrolling
+    only ever read about one bucket per pixel. The mouse wheel zooms in and
+    out around the pointer; while zoomed in, the view pages along to keep
+    the playhead on screen.
+
+    The waveform is drawn once into an offscreen layer, redrawn only when
+    the track, the zoom or the size changes. Moving the playhead repaints
+    just the strips it leaves and enters.
 */
 class WaveformDisplay    : public Component, 
-                           public ChangeListener
+                           private Timer
 {
 public:
-    /** Create a waveform display using the given format manager and cache */
-    WaveformDisplay( AudioFormatManager & 	formatManagerToUse,
-                    AudioThumbnailCache & 	cacheToUse );
+    /** Create a waveform display that decodes with the given format manager */
+    WaveformDisplay( AudioFormatManager & 	formatManagerToUse );
     ~WaveformDisplay();
 
-    /** Draw the waveform thumbnail and playhead position */
+    /** Draw the waveform and playhead position */
     void paint (Graphics&) override;
     void resized() override;
 
-    /** Repaint when the audio thumbnail data changes */
-    void changeListenerCallback (ChangeBroadcaster *source) override;
+    /** Zoom in or out around the mouse pointer */
+    void mouseWheelMove(const MouseEvent& e, const MouseWheelDetails& wheel) override;
 
-    /** Load an audio file to display its waveform */
+    /** Load an audio file to display its waveform. A track whose waveform
+        is in the disk cache is shown whole straight away; any other is
+        built on a background thread, drawn as it comes in and then cached. */
     void loadURL(URL audioURL);
+    /** Show nothing until the next loadURL() */
+    void clear();
+
+    /** Return the waveform being shown, to share it with another view */
+    std::shared_ptr<WaveformPyramid> getPyramid() const { return pyramid; }
+    /** Show a waveform built by another display (null shows nothing) */
+    void setPyramid(std::shared_ptr<WaveformPyramid> newPyramid);
+    /** Stop showing the waveform without cancelling its build, and return it */
+    std::shared_ptr<WaveformPyramid> takePyramid();
+
+    /** Draw the track from firstSample onwards into area, one column per
+        pixel, with the peaks behind the RMS level, coloured by band. Safe
+        on any thread. */
+    static void drawWaveform(Graphics& g, const WaveformPyramid& pyramid,
+                             double firstSample, double samplesPerPixel, Rectangle<int> area);
+    /** Return the colour for a stretch of the track from its band levels */
+    static Colour getBandColour(const WaveformPyramid::Summary& summary);
 
     /** Set the relative position of the playhead (0.0 to 1.0) */
     void setPositionRelative(double pos);
 
 private:
-    AudioThumbnail audioThumb;
+    /** Background threads shared by every waveform display */
+    struct BuilderPool : public ThreadPool
+    {
+        BuilderPool() : ThreadPool(2) {}
+    };
+
+    /** Repaint while the waveform is still being built */
+    void timerCallback() override;
+
+    /** Drop the offscreen layer and repaint everything */
+    void invalidateLayer();
+    /** Return the area the playhead covers, or an empty one if it is off screen */
+    Rectangle<int> getPlayheadArea() const;
+
+    AudioFormatManager& formatManager;
+    std::shared_ptr<WaveformPyramid> pyramid;
     bool fileLoaded; 
     double position;
+    Range<double> visibleRange { 0.0, 1.0 };   // fractions of the track
+    Image waveformLayer;                        // background, border and waveform
+
+    SharedResourcePointer<WaveformCache> waveformCache;
+    SharedResourcePointer<BuilderPool> builderPool;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformDisplay)
 };
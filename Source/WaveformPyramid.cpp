@@ -0,0 +1,315 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.cpp
+    Created: 18 Oct 2026 9:04:12pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#include "WaveformPyramid.h"
+#include <cstring>
+
+namespace
+{
+    // Base buckets decoded between each publish
+    constexpr int bucketsPerChunk = 512;
+
+    // Crossovers between the bands
+    constexpr double lowCrossoverHz = 200.0;
+    constexpr double highCrossoverHz = 2000.0;
+
+    int8 toLevel(float value)
+    {
+        return (int8) roundToInt(jlimit(-1.0f, 1.0f, value) * 127.0f);
+    }
+
+    uint8 toRms(double sumSquares, int count)
+    {
+        return (uint8) roundToInt(jlimit(0.0, 1.0, std::sqrt(sumSquares / count)) * 255.0);
+    }
+
+    uint8 mergeRms(uint8 a, uint8 b)
+    {
+        return (uint8) roundToInt(std::sqrt(((float) a * a + (float) b * b) * 0.5f));
+    }
+
+    // Saved pyramids: magic, version, length, sample rate, bucket size, then the buckets
+    constexpr uint32 fileMagic = ByteOrder::makeInt('O', 'T', 'W', 'P');
+    constexpr int fileVersion = 1;
+    constexpr size_t headerBytes = 4 + 4 + 8 + 8 + 4 + 4;
+
+    static_assert (sizeof (WaveformPyramid::Bucket) == 6, "Buckets are saved and mapped as they are");
+
+    /** Coefficient of a one-pole low-pass */
+    float onePole(double cutoffHz, double sampleRate)
+    {
+        return (float) (1.0 - std::exp(-MathConstants<double>::twoPi * cutoffHz / sampleRate));
+    }
+}
+
+bool WaveformPyramid::build(AudioFormatReader* reader)
+{
+    if (cancelled.load())
+        return false;
+
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->numChannels == 0)
+    {
+        failed.store(true);
+        return false;
+    }
+
+    allocate(reader->lengthInSamples, reader->sampleRate);
+
+    const int numChannels = jmin(2, (int) reader->numChannels);
+    AudioBuffer<float> chunk(numChannels, bucketsPerChunk * baseBucketSamples);
+    int64 bucketIndex = 0;
+
+    const double rate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    const float lowCoeff = onePole(lowCrossoverHz, rate);
+    const float highCoeff = onePole(highCrossoverHz, rate);
+    float belowLow = 0.0f, belowHigh = 0.0f;
+
+    for (int64 start = 0; start < lengthInSamples; start += chunk.getNumSamples())
+    {
+        if (cancelled.load())
+            return false;
+
+        const int numSamples = (int) jmin((int64) chunk.getNumSamples(), lengthInSamples - start);
+        reader->read(&chunk, 0, numSamples, start, true, true);
+
+        for (int offset = 0; offset < numSamples; offset += baseBucketSamples)
+        {
+            const int n = jmin(baseBucketSamples, numSamples - offset);
+            float lo = 0.0f, hi = 0.0f;
+            double sumSquares = 0.0;
+            double bandSquares[numBands] = { 0.0, 0.0, 0.0 };
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto range = FloatVectorOperations::findMinAndMax(chunk.getReadPointer(ch, offset), n);
+                lo = jmin(lo, range.getStart());
+                hi = jmax(hi, range.getEnd());
+            }
+
+            const float* left = chunk.getReadPointer(0, offset);
+            const float* right = chunk.getReadPointer(numChannels - 1, offset);
+
+            for (int i = 0; i < n; ++i)
+            {
+                sumSquares += (left[i] * left[i] + right[i] * right[i]) * 0.5f;
+
+                // Split the mid channel: low = below 200 Hz, high = above 2 kHz
+                const float mono = (left[i] + right[i]) * 0.5f;
+                belowLow += lowCoeff * (mono - belowLow);
+                belowHigh += highCoeff * (mono - belowHigh);
+
+                const float bandLow = belowLow;
+                const float bandMid = belowHigh - belowLow;
+                const float bandHigh = mono - belowHigh;
+
+                bandSquares[low] += bandLow * bandLow;
+                bandSquares[mid] += bandMid * bandMid;
+                bandSquares[high] += bandHigh * bandHigh;
+            }
+
+            Bucket bucket;
+            bucket.min = toLevel(lo);
+            bucket.max = toLevel(hi);
+            bucket.rms = toRms(sumSquares, n);
+
+            for (int band = 0; band < numBands; ++band)
+                bucket.bands[band] = toRms(bandSquares[band], n);
+
+            addBucket(bucketIndex++, bucket);
+        }
+
+        // Only whole buckets are published until the end; the last one may be short
+        samplesReady.store((start + numSamples) / baseBucketSamples * baseBucketSamples,
+                           std::memory_order_release);
+    }
+
+    finishLevels();
+    samplesReady.store(lengthInSamples, std::memory_order_release);
+    return true;
+}
+
+void WaveformPyramid::setLength(int64 numSamples, double rate)
+{
+    lengthInSamples = numSamples;
+    sampleRate = rate;
+
+    size_t size = (size_t) ((numSamples + baseBucketSamples - 1) / baseBucketSamples);
+    levels.push_back({ 0, size });
+
+    while (size > 1)
+    {
+        size = (size + 1) / 2;
+        levels.push_back({ levels.back().offset + levels.back().size, size });
+    }
+}
+
+void WaveformPyramid::allocate(int64 numSamples, double rate)
+{
+    setLength(numSamples, rate);
+    storage.resize(getTotalBuckets());
+    buckets = storage.data();
+
+    prepared.store(true, std::memory_order_release);
+}
+
+void WaveformPyramid::addBucket(int64 index, const Bucket& bucket)
+{
+    at(0, (size_t) index) = bucket;
+
+    // Each second bucket completes a pair, and so on up the levels
+    for (size_t level = 1; level < levels.size() && (index & 1) != 0; ++level)
+    {
+        index >>= 1;
+        at(level, (size_t) index) = merge(at(level - 1, (size_t) index * 2), at(level - 1, (size_t) index * 2 + 1));
+    }
+}
+
+void WaveformPyramid::finishLevels()
+{
+    // The last bucket on each level may have had no partner below it
+    for (size_t level = 1; level < levels.size(); ++level)
+    {
+        const size_t last = levels[level].size - 1;
+
+        at(level, last) = last * 2 + 1 < levels[level - 1].size ? merge(at(level - 1, last * 2), at(level - 1, last * 2 + 1))
+                                                                 : at(level - 1, last * 2);
+    }
+}
+
+bool WaveformPyramid::loadFrom(const File& file)
+{
+    auto mapped = std::make_unique<MemoryMappedFile>(file, MemoryMappedFile::readOnly);
+    const auto* data = static_cast<const char*>(mapped->getData());
+
+    if (data == nullptr || mapped->getSize() < headerBytes
+        || ByteOrder::littleEndianInt(data) != fileMagic
+        || ByteOrder::littleEndianInt(data + 4) != (uint32) fileVersion
+        || ByteOrder::littleEndianInt(data + 24) != (uint32) sizeof(Bucket))
+        return false;
+
+    const int64 numSamples = (int64) ByteOrder::littleEndianInt64(data + 8);
+    const uint64 rateBits = ByteOrder::littleEndianInt64(data + 16);
+    double rate;
+    std::memcpy(&rate, &rateBits, sizeof(rate));
+
+    if (numSamples <= 0 || ! (rate > 0.0))
+        return false;
+
+    setLength(numSamples, rate);
+
+    if (mapped->getSize() != headerBytes + getTotalBuckets() * sizeof(Bucket))
+    {
+        levels.clear();
+        return false;
+    }
+
+    buckets = reinterpret_cast<const Bucket*>(data + headerBytes);
+    mappedFile = std::move(mapped);
+
+    samplesReady.store(lengthInSamples, std::memory_order_release);
+    prepared.store(true, std::memory_order_release);
+    return true;
+}
+
+bool WaveformPyramid::writeTo(const File& file) const
+{
+    if (! isComplete())
+        return false;
+
+    // Written to a temporary file and moved over, so a crash never leaves half a pyramid
+    TemporaryFile temp(file);
+
+    {
+        FileOutputStream out(temp.getFile());
+        if (out.failedToOpen())
+            return false;
+
+        uint64 rateBits;
+        std::memcpy(&rateBits, &sampleRate, sizeof(rateBits));
+
+        out.writeInt((int) fileMagic);
+        out.writeInt(fileVersion);
+        out.writeInt64(lengthInSamples);
+        out.writeInt64((int64) rateBits);
+        out.writeInt((int) sizeof(Bucket));
+        out.writeInt(0);
+        out.write(buckets, getTotalBuckets() * sizeof(Bucket));
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+WaveformPyramid::Bucket WaveformPyramid::merge(const Bucket& a, const Bucket& b)
+{
+    Bucket merged;
+    merged.min = jmin(a.min, b.min);
+    merged.max = jmax(a.max, b.max);
+    merged.rms = mergeRms(a.rms, b.rms);
+
+    for (int band = 0; band < numBands; ++band)
+        merged.bands[band] = mergeRms(a.bands[band], b.bands[band]);
+
+    return merged;
+}
+
+int WaveformPyramid::getLevelFor(double samplesPerPixel) const
+{
+    int level = 0;
+    while (level + 1 < getNumLevels() && (double) getBucketSamples(level + 1) <= samplesPerPixel)
+        ++level;
+
+    return level;
+}
+
+bool WaveformPyramid::getSummary(int level, int64 startSample, int64 endSample, Summary& result) const
+{
+    if (! isPrepared() || ! isPositiveAndBelow(level, getNumLevels()))
+        return false;
+
+    const auto& info = levels[(size_t) level];
+    const Bucket* levelBuckets = buckets + info.offset;
+    const int64 width = getBucketSamples(level);
+    const int64 ready = isComplete() ? (int64) info.size : getSamplesReady() / width;
+
+    const int64 first = jmax((int64) 0, startSample / width);
+    const int64 last = jmin(ready, jmax(first + 1, (endSample + width - 1) / width));
+
+    if (first >= last)
+        return false;
+
+    int lo = 127, hi = -127;
+    float sumSquares = 0.0f;
+    float bandSquares[numBands] = { 0.0f, 0.0f, 0.0f };
+
+    for (int64 i = first; i < last; ++i)
+    {
+        const auto& bucket = levelBuckets[i];
+        lo = jmin(lo, (int) bucket.min);
+        hi = jmax(hi, (int) bucket.max);
+        sumSquares += (float) bucket.rms * bucket.rms;
+
+        for (int band = 0; band < numBands; ++band)
+            bandSquares[band] += (float) bucket.bands[band] * bucket.bands[band];
+    }
+
+    const float count = (float) (last - first);
+    result.min = (float) lo / 127.0f;
+    result.max = (float) hi / 127.0f;
+    result.rms = std::sqrt(sumSquares / count) / 255.0f;
+
+    for (int band = 0; band < numBands; ++band)
+        result.bands[band] = std::sqrt(bandSquares[band] / count) / 255.0f;
+
+    return true;
+}
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.h
+    Created: 18 Oct 2026 9:04:12pm
+    Author:  Chandrasekaran Akhshayaa
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/** A min/max/RMS summary of a track at every power-of-two zoom level.
+
+    Level 0 summarises each run of baseBucketSamples samples, and each level
+    above it merges pairs of buckets from the one below, so whatever the
+    zoom there is a level with between one and two buckets per pixel and
+    drawing costs the same for a 3-minute track as for a 2-hour mix.
+
+    Each bucket also holds the RMS level of the low, mid and high bands,
+    split by one-pole crossovers at 200 Hz and 2 kHz in the same pass, so
+    the waveform can be coloured by where the energy sits without any
+    filtering at draw time.
+
+    build() decodes the track once, in chunks, on a background thread.
+    Buckets are published as each chunk finishes, so the GUI can draw the
+    part that is ready while the rest is still decoding. Values are stored
+    as bytes: a pixel column has far fewer steps than that.
+
+    Every level is kept in one flat array, which writeTo() saves as it is,
+    so loadFrom() can map a saved pyramid straight from disk (see
+    WaveformCache).
+*/
+class WaveformPyramid
+{
+public:
+    static constexpr int baseBucketSamples = 128;
+
+    enum Band { low = 0, mid = 1, high = 2, numBands = 3 };
+
+    /** One bucket: the lowest and highest sample (-127 to 127), and the RMS
+        level of the whole signal and of each band (0 to 255) */
+    struct Bucket
+    {
+        int8 min = 0;
+        int8 max = 0;
+        uint8 rms = 0;
+        uint8 bands[numBands] = { 0, 0, 0 };
+    };
+
+    /** A stretch of the track summarised from one or more buckets (-1 to 1) */
+    struct Summary
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        float rms = 0.0f;
+        float bands[numBands] = { 0.0f, 0.0f, 0.0f };
+    };
+
+    WaveformPyramid() = default;
+
+    /** Decode the whole track into the pyramid (background thread). Returns
+        false if it was cancelled; a null or empty reader marks the pyramid
+        as failed. */
+    bool build(AudioFormatReader* reader);
+    /** Ask a build() in progress to stop at the next chunk (any thread) */
+    void cancel() { cancelled.store(true); }
+
+    /** Map a pyramid saved by writeTo() instead of building one. Returns
+        false if the file isn't a complete pyramid. */
+    bool loadFrom(const File& file);
+    /** Save a complete pyramid for loadFrom() */
+    bool writeTo(const File& file) const;
+
+    /** Check whether build() was given nothing it could read */
+    bool hasFailed() const { return failed.load(); }
+    /** Check whether build() has got far enough to know the track's length */
+    bool isPrepared() const { return prepared.load(std::memory_order_acquire); }
+    /** Check whether every sample has been summarised */
+    bool isComplete() const { return isPrepared() && samplesReady.load(std::memory_order_acquire) >= lengthInSamples; }
+
+    /** These are valid once isPrepared() returns true */
+    int64 getLengthInSamples() const { return lengthInSamples; }
+    double getSampleRate() const { return sampleRate; }
+    int getNumLevels() const { return (int) levels.size(); }
+    /** Return how many buckets there are on all levels together */
+    size_t getTotalBuckets() const { return levels.empty() ? 0 : levels.back().offset + levels.back().size; }
+    int64 getSamplesReady() const { return samplesReady.load(std::memory_order_acquire); }
+
+    /** Return the number of samples a bucket covers on a level */
+    static int64 getBucketSamples(int level) { return (int64) baseBucketSamples << level; }
+    /** Return the coarsest level whose buckets are no wider than samplesPerPixel */
+    int getLevelFor(double samplesPerPixel) const;
+
+    /** Summarise samples [startSample, endSample) from the finished buckets
+        on one level. Returns false if none of them are ready yet. */
+    bool getSummary(int level, int64 startSample, int64 endSample, Summary& result) const;
+
+private:
+    struct Level
+    {
+        size_t offset = 0;      // into the flat bucket array
+        size_t size = 0;
+    };
+
+    void setLength(int64 numSamples, double rate);
+    void allocate(int64 numSamples, double rate);
+    void addBucket(int64 index, const Bucket& bucket);
+    void finishLevels();
+    Bucket& at(size_t level, size_t index) { return storage[levels[level].offset + index]; }
+
+    static Bucket merge(const Bucket& a, const Bucket& b);
+
+    // The buckets are read through buckets, which points into storage for a
+    // pyramid built here or into mappedFile for one loaded from disk. Both
+    // are sized once and never resized, so readers can index them while
+    // the builder fills in later buckets.
+    std::vector<Level> levels;
+    std::vector<Bucket> storage;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    const Bucket* buckets = nullptr;
+    int64 lengthInSamples = 0;
+    double sampleRate = 0.0;
+
+    std::atomic<int64> samplesReady { 0 };
+    std::atomic<bool> prepared { false };
+    std::atomic<bool> cancelled { false };
+    std::atomic<bool> failed { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformPyramid)
+};